@@ -0,0 +1,193 @@
+// Copyright (c) 2025, Yakov Usoltsev
+// Email: yakovmen62@gmail.com
+//
+// License: MIT
+
+// Throughput of id-utils implementations, build with optimizations.
+
+#include <cu/id-utils.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <random>
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::cout, std::endl;
+
+static constexpr size_t IDS_PER_THREAD = 16;
+static constexpr size_t OPERATIONS_PER_THREAD = 1 << 18;
+
+// returns millions of operations per second, every thread calls work() OPERATIONS_PER_THREAD times
+template<typename Work>
+static double measure_throughput(size_t threads_count, Work&& work) {
+    std::vector<std::thread> threads;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < threads_count; i++) {
+        threads.emplace_back(work);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+
+    return double(threads_count * OPERATIONS_PER_THREAD) / elapsed.count();
+}
+
+static void print_result(const std::string& name, size_t threads_count, double throughput) {
+    cout << std::setw(36) << std::left << name
+         << std::setw(4) << std::right << threads_count << " threads: "
+         << std::fixed << std::setprecision(2) << throughput << " Mops/s" << endl;
+}
+
+// every thread locks IDS_PER_THREAD identifiers and frees them, one operation is a pair of LockId/FreeId
+template<typename Pool, typename Lock, typename Free>
+static void benchmark_id_pool(const std::string& name, size_t threads_count, Pool& pool, Lock&& lock, Free&& free) {
+    const auto throughput = measure_throughput(threads_count, [&] {
+        CU::id_t ids[IDS_PER_THREAD];
+        for (size_t i = 0; i < OPERATIONS_PER_THREAD / IDS_PER_THREAD; i++) {
+            for (auto& id : ids) {
+                id = lock(pool);
+            }
+            for (auto id : ids) {
+                free(pool, id);
+            }
+        }
+        });
+    print_result(name, threads_count, throughput);
+}
+
+static void benchmark_id_pools() {
+    for (size_t threads_count = 1; threads_count <= 64; threads_count *= 2) {
+        {
+            CU::IdPool pool;
+            std::mutex pool_mutex;
+            benchmark_id_pool("IdPool + std::mutex", threads_count, pool,
+                [&](CU::IdPool& p) { std::scoped_lock _(pool_mutex); return p.LockId(); },
+                [&](CU::IdPool& p, CU::id_t id) { std::scoped_lock _(pool_mutex); p.FreeId(id); });
+        }
+        {
+            CU::ConcurrentIdPool pool{ CU::id_t(threads_count * IDS_PER_THREAD) };
+            benchmark_id_pool("ConcurrentIdPool", threads_count, pool,
+                [](CU::ConcurrentIdPool& p) { return p.LockId(); },
+                [](CU::ConcurrentIdPool& p, CU::id_t id) { p.FreeId(id); });
+        }
+    }
+}
+
+static void benchmark_uid_generators() {
+    for (size_t threads_count = 1; threads_count <= 64; threads_count *= 2) {
+        {
+            // the previous implementation of UidGeneratorT
+            std::mutex counter_mutex;
+            CU::uid_t counter = 0;
+            print_result("uid counter + std::mutex", threads_count, measure_throughput(threads_count, [&] {
+                for (size_t i = 0; i < OPERATIONS_PER_THREAD; i++) {
+                    std::scoped_lock _(counter_mutex);
+                    counter++;
+                }
+                }));
+        }
+        print_result("UidGenerator::Get", threads_count, measure_throughput(threads_count, [] {
+            for (size_t i = 0; i < OPERATIONS_PER_THREAD; i++) {
+                CU::UidGenerator::Get();
+            }
+            }));
+        print_result("UidGenerator::GetFromThreadBlock", threads_count, measure_throughput(threads_count, [] {
+            for (size_t i = 0; i < OPERATIONS_PER_THREAD; i++) {
+                CU::UidGenerator::GetFromThreadBlock<1024>();
+            }
+            }));
+        print_result("SnowflakeUidGenerator::Get", threads_count, measure_throughput(threads_count, [] {
+            for (size_t i = 0; i < OPERATIONS_PER_THREAD; i++) {
+                CU::SnowflakeUidGenerator::Get();
+            }
+            }));
+    }
+}
+
+static void benchmark_unique_names() {
+    constexpr size_t NAMES_COUNT = 1 << 20;
+    const std::string name = "entity";
+    size_t checksum = 0;
+
+    // the previous implementation of concat_with_uid
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NAMES_COUNT; i++) {
+        std::stringstream ss;
+        ss << name << " {" << std::hex << std::setw(CU::UID_STR_WIDTH) << std::setfill('0') << CU::uid_t(i) << "}";
+        checksum += ss.str().size();
+    }
+    auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+    print_result("concat_with_uid, std::stringstream", 1, double(NAMES_COUNT) / elapsed.count());
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NAMES_COUNT; i++) {
+        checksum += CU::concat_with_uid(name, CU::uid_t(i)).size();
+    }
+    elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+    print_result("concat_with_uid, std::string", 1, double(NAMES_COUNT) / elapsed.count());
+
+    std::array<char, 64> buffer;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NAMES_COUNT; i++) {
+        const auto unique_name = CU::concat_with_uid(name, CU::uid_t(i), buffer);
+        checksum += CU::extract_uid(unique_name) + CU::uid_extract_name_view(unique_name).size();
+    }
+    elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+    print_result("concat_with_uid + extract, buffer", 1, double(NAMES_COUNT) / elapsed.count());
+
+    // prevents optimizing out the loops
+    if (!checksum)
+        cout << checksum << endl;
+}
+
+// LIVE_IDS_COUNT identifiers are locked, then random identifiers are freed and locked again
+template<typename Pool>
+static void benchmark_large_id_pool(const std::string& name) {
+    constexpr size_t LIVE_IDS_COUNT = 1 << 22;
+    constexpr size_t REUSED_IDS_COUNT = 1 << 20;
+
+    // unique identifiers in random order
+    std::vector<CU::id_t> reused_ids;
+    std::vector<bool> is_reused(LIVE_IDS_COUNT);
+    std::mt19937 generator{ 42 };
+    for (size_t i = 0; i < REUSED_IDS_COUNT; i++) {
+        const auto id = CU::id_t(generator() % (LIVE_IDS_COUNT - 1));
+        if (!is_reused[id]) {
+            is_reused[id] = true;
+            reused_ids.push_back(id);
+        }
+    }
+
+    Pool pool;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < LIVE_IDS_COUNT; i++) {
+        pool.LockId();
+    }
+    for (auto id : reused_ids) {
+        pool.FreeId(id);
+    }
+    for (size_t i = 0; i < reused_ids.size(); i++) {
+        pool.LockId();
+    }
+    const auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+
+    print_result(name, 1, double(LIVE_IDS_COUNT + 2 * reused_ids.size()) / elapsed.count());
+}
+
+int main() {
+    benchmark_large_id_pool<CU::IdPool>("IdPool, 4M live ids");
+    benchmark_large_id_pool<CU::BitmapIdPool>("BitmapIdPool, 4M live ids");
+
+    benchmark_id_pools();
+    benchmark_uid_generators();
+    benchmark_unique_names();
+    return 0;
+}
@@ -4,9 +4,67 @@
 # License: MIT
 
 include(StringUtils)
+include(CheckCXXSourceCompiles)
 
 # helpers
 
+# profiles of instructions sets, see CU::InstructionsProfile (it checks every set enabled here)
+set(CU_SIMD_X86_64_V4_FLAGS
+    -mavx2 -mfma -mbmi -mbmi2 -mlzcnt -mmovbe -mf16c
+    -mavx512f -mavx512bw -mavx512cd -mavx512dq -mavx512vl)
+set(CU_SIMD_AVX512_VNNI_FLAGS ${CU_SIMD_X86_64_V4_FLAGS} -mavx512vnni)
+set(CU_SIMD_AVX512_FP16_FLAGS ${CU_SIMD_X86_64_V4_FLAGS} -mavx512fp16)
+set(CU_SIMD_PROFILES X86_64_V4 AVX512_VNNI AVX512_FP16)
+
+# AArch64 sets, Advanced SIMD is the part of the base architecture.
+# The features are appended to the architecture of the build (-march of CMAKE_CXX_FLAGS, armv8-a by default),
+# so the units never target an older architecture than the rest of the code.
+set(CU_SIMD_AARCH64_ARCH armv8-a)
+if (CMAKE_CXX_FLAGS MATCHES "-march=([^ ]+)")
+    set(CU_SIMD_AARCH64_ARCH ${CMAKE_MATCH_1})
+endif()
+set(CU_SIMD_NEON_FLAGS -march=${CU_SIMD_AARCH64_ARCH}+simd)
+set(CU_SIMD_SVE_FLAGS  -march=${CU_SIMD_AARCH64_ARCH}+sve)
+set(CU_SIMD_SVE2_FLAGS -march=${CU_SIMD_AARCH64_ARCH}+sve2)
+
+# sets available for the target processor, the others are skipped
+set(CU_SIMD_X86_64_SETS SSE SSE2 SSE3 SSSE3 SSE4_1 SSE4_2 AVX AVX2 AVX512 ${CU_SIMD_PROFILES})
+set(CU_SIMD_AARCH64_SETS NEON SVE SVE2)
+if (CMAKE_SYSTEM_PROCESSOR STREQUAL "x86_64" OR CMAKE_SYSTEM_PROCESSOR STREQUAL "AMD64")
+    set(CU_SIMD_TARGET_SETS ${CU_SIMD_X86_64_SETS})
+elseif (CMAKE_SYSTEM_PROCESSOR STREQUAL "aarch64" OR CMAKE_SYSTEM_PROCESSOR STREQUAL "arm64" OR CMAKE_SYSTEM_PROCESSOR STREQUAL "ARM64")
+    set(CU_SIMD_TARGET_SETS ${CU_SIMD_AARCH64_SETS})
+else()
+    set(CU_SIMD_TARGET_SETS "")
+endif()
+
+function(get_simd_compile_unit_flags
+    instructions_set
+    flags
+)
+    set(ARCH_FLAGS "")
+    if (instructions_set IN_LIST CU_SIMD_PROFILES)
+        if (CMAKE_CXX_COMPILER_ID MATCHES "MSVC")
+            set(ARCH_FLAGS "/arch:AVX512")
+        else()
+            set(ARCH_FLAGS ${CU_SIMD_${instructions_set}_FLAGS})
+        endif()
+    elseif (instructions_set IN_LIST CU_SIMD_AARCH64_SETS)
+        # MSVC enables NEON by default and doesn't support SVE
+        if (NOT CMAKE_CXX_COMPILER_ID MATCHES "MSVC")
+            set(ARCH_FLAGS ${CU_SIMD_${instructions_set}_FLAGS})
+        endif()
+    elseif (CMAKE_CXX_COMPILER_ID MATCHES "MSVC")
+        set(ARCH_FLAGS "/arch:${instructions_set}")
+    elseif ((CMAKE_CXX_COMPILER_ID MATCHES "GNU") OR (CMAKE_CXX_COMPILER_ID MATCHES "Clang"))
+        string(TOLOWER ${instructions_set} instructions_set_lower)
+        string(REPLACE "_" "." instructions_set_name "${instructions_set_lower}")
+        set(ARCH_FLAGS "-m${instructions_set_name}")
+    endif() # GCC & Clang
+
+    set(${flags} ${ARCH_FLAGS} PARENT_SCOPE)
+endfunction()
+
 function(set_simd_compile_unit_flag
     file_path
     instructions_set
@@ -15,20 +73,37 @@ function(set_simd_compile_unit_flag
         return()
     endif()
 
-    if (CMAKE_CXX_COMPILER_ID MATCHES "MSVC")
-        set(ARCH_FLAG "/arch:${instructions_set}")
-    elseif ((CMAKE_CXX_COMPILER_ID MATCHES "GNU") OR (CMAKE_CXX_COMPILER_ID MATCHES "Clang"))
-        string(TOLOWER ${instructions_set} instructions_set_lower)
-        string(REPLACE "_" "." instructions_set_name "${instructions_set_lower}")
-        set(ARCH_FLAG "-m${instructions_set_name}")
-    endif() # GCC & Clang
+    get_simd_compile_unit_flags(${instructions_set} ARCH_FLAGS)
 
-    set_source_files_properties(${file_path}
-        PROPERTIES
-            COMPILE_OPTIONS ${ARCH_FLAG}
+    # sets of a group are appended one by one
+    set_property(SOURCE ${file_path}
+        APPEND PROPERTY
+            COMPILE_OPTIONS ${ARCH_FLAGS}
     )
 endfunction()
 
+# checks that the compiler supports all the flags of the instructions set
+function(is_simd_compile_unit_supported
+    instructions_set
+    is_supported
+)
+    set(${is_supported} TRUE PARENT_SCOPE)
+    if ((CMAKE_CXX_COMPILER_ID MATCHES "MSVC") AND (instructions_set MATCHES "^SVE"))
+        set(${is_supported} FALSE PARENT_SCOPE)
+        return()
+    endif()
+    if ((instructions_set STREQUAL "DEF") OR (CMAKE_CXX_COMPILER_ID MATCHES "MSVC"))
+        return()
+    endif()
+
+    get_simd_compile_unit_flags(${instructions_set} ARCH_FLAGS)
+    string(MAKE_C_IDENTIFIER "CU_SIMD_FLAGS_${instructions_set}" CHECK_RESULT)
+    set(CMAKE_REQUIRED_FLAGS ${ARCH_FLAGS})
+    list(JOIN CMAKE_REQUIRED_FLAGS " " CMAKE_REQUIRED_FLAGS)
+    check_cxx_source_compiles("int main() { return 0; }" ${CHECK_RESULT})
+    set(${is_supported} ${${CHECK_RESULT}} PARENT_SCOPE)
+endfunction()
+
 function(parse_simd_sets_group
     sets_group
     is_single
@@ -62,7 +137,15 @@ endfunction()
 #               Supported values:
 #               function – supports standalone C-style functions
 #               class – supports class-based implementation with inheritance and polymorphism
-#  supported_sets — the list of supported instruction sets
+#  supported_sets — the list of supported instruction sets.
+#                   A group of sets compiled together is written as "AVX512(F,BW,VL)".
+#                   Profiles X86_64_V4, AVX512_VNNI and AVX512_FP16 enable all sets of the profile
+#                   (see CU::InstructionsProfile), they are skipped if the compiler doesn't support them.
+#                   Profile variants are selected for AUTO_INSET or by the profile, never for a single set
+#                   (CU::SimdFunction::Get and the make_<implementation> factories of classes).
+#                   AArch64 sets NEON, SVE and SVE2 are skipped in the same way.
+#                   Sets of other processors than the target one are skipped, so the same list
+#                   can be used for x86-64 and AArch64 builds.
 #
 # Preconditions:
 # Files <implementation>_iface.hpp and <implementation>_impl.hpp
@@ -84,6 +167,12 @@ function(generate_simd_compile_units
     set(CU_SIMD_SUPPORT_AVX    0)
     set(CU_SIMD_SUPPORT_AVX2   0)
     set(CU_SIMD_SUPPORT_AVX512 0)
+    foreach(profile IN LISTS CU_SIMD_PROFILES)
+        set(CU_SIMD_SUPPORT_${profile} 0)
+    endforeach()
+    foreach(aarch64_set IN LISTS CU_SIMD_AARCH64_SETS)
+        set(CU_SIMD_SUPPORT_${aarch64_set} 0)
+    endforeach()
 
     set(IMPLEMENTATION_NAME ${implementation})
     if (${logic_unit} MATCHES "function")
@@ -107,6 +196,19 @@ function(generate_simd_compile_units
     foreach(supported_set IN LISTS ARGN)
         parse_simd_sets_group(supported_set is_single sets_list)
 
+        if (NOT (supported_set STREQUAL "DEF") AND NOT (supported_set IN_LIST CU_SIMD_TARGET_SETS))
+            message(STATUS "${IMPLEMENTATION_NAME}: ${supported_set} is not available for ${CMAKE_SYSTEM_PROCESSOR}, skipped")
+            continue()
+        endif()
+
+        if ((supported_set IN_LIST CU_SIMD_PROFILES) OR (supported_set IN_LIST CU_SIMD_AARCH64_SETS))
+            is_simd_compile_unit_supported(${supported_set} is_supported)
+            if (NOT is_supported)
+                message(WARNING "${IMPLEMENTATION_NAME}: ${supported_set} is not supported by the compiler, skipped")
+                continue()
+            endif()
+        endif()
+
         set(SUPPORT_FLAG_NAME "CU_SIMD_SUPPORT_${supported_set}")
         set(${SUPPORT_FLAG_NAME} 1)
         set(CURRENT_SUPPORTED_SET ${supported_set})
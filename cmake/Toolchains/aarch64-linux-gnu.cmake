@@ -0,0 +1,29 @@
+# Copyright (c) 2025, Yakov Usoltsev
+# Email: yakovmen62@gmail.com
+#
+# License: MIT
+
+# Cross compilation for AArch64 Linux with the GNU toolchain.
+# The binaries are run by qemu-user, e.g. tests:
+#   cmake -S . -B build-aarch64 -DCMAKE_TOOLCHAIN_FILE=cmake/Toolchains/aarch64-linux-gnu.cmake
+#   cmake --build build-aarch64
+#   qemu-aarch64 -cpu max -L /usr/aarch64-linux-gnu build-aarch64/tests/simd-test/simd-test
+# '-cpu max' enables SVE and SVE2, '-cpu cortex-a72' is NEON only.
+
+set(CMAKE_SYSTEM_NAME Linux)
+set(CMAKE_SYSTEM_PROCESSOR aarch64)
+
+set(CU_AARCH64_TOOLCHAIN_PREFIX aarch64-linux-gnu- CACHE STRING "Prefix of the cross compilers")
+set(CU_AARCH64_SYSROOT /usr/aarch64-linux-gnu CACHE PATH "Root of the target libraries")
+
+set(CMAKE_C_COMPILER   ${CU_AARCH64_TOOLCHAIN_PREFIX}gcc)
+set(CMAKE_CXX_COMPILER ${CU_AARCH64_TOOLCHAIN_PREFIX}g++)
+
+set(CMAKE_FIND_ROOT_PATH ${CU_AARCH64_SYSROOT})
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_PACKAGE ONLY)
+
+# used by try_run and add_test
+set(CMAKE_CROSSCOMPILING_EMULATOR qemu-aarch64 -cpu max -L ${CU_AARCH64_SYSROOT})
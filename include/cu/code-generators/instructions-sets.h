@@ -240,7 +240,7 @@ struct CPUConfiguration {
 // see https://learn.microsoft.com/en-us/cpp/intrinsics/cpuid-cpuidex
 
 #define READ_REGISTERS \
-    std::array<int, 4> cpu_descr;  \
+    std::array<int, 4> cpu_descr = {}; \
     __cpuid(cpu_descr.data(), 0);  \
     int fID_number = cpu_descr[0]; \
     std::unordered_map<std::string, std::array<int, 4>> registers_values; \
@@ -264,6 +264,30 @@ struct CPUConfiguration {
 
 #endif // CU_ARCH_X86_64
 
+#ifdef  CU_ARCH_AARCH64
+
+#if defined(__linux__)
+// see https://docs.kernel.org/arch/arm64/elf_hwcaps.html
+// the features are readable by the user space without traps, so it works under emulators too
+
+#define READ_REGISTERS \
+    std::unordered_map<std::string, std::array<int, 4>> registers_values; \
+    const auto hwcap = uint64_t(getauxval(AT_HWCAP)); \
+    const auto hwcap2 = uint64_t(getauxval(AT_HWCAP2)); \
+    registers_values["HWCAP"] = { int(uint32_t(hwcap)), int(uint32_t(hwcap >> 32)), 0, 0 }; \
+    registers_values["HWCAP2"] = { int(uint32_t(hwcap2)), int(uint32_t(hwcap2 >> 32)), 0, 0 };
+#else
+// Advanced SIMD is the part of the base architecture, other features are unknown
+#define READ_REGISTERS \
+    std::unordered_map<std::string, std::array<int, 4>> registers_values; \
+    registers_values["HWCAP"] = { 1 << 1, 0, 0, 0 };
+#endif // Linux
+
+#define AUXV_LO 0
+#define AUXV_HI 1
+
+#endif // CU_ARCH_AARCH64
+
 #define EAX 0
 #define EBX 1
 #define ECX 2
@@ -17,6 +17,11 @@
 #include <bitset>
 #include <cstring>
 #include <limits>
+#include <atomic>
+#include <initializer_list>
+#include <iostream>
+#include <utility>
+#include <stdexcept>
 
 #ifdef CU_ARCH_X86_64
 
@@ -48,6 +53,21 @@ static inline void __cpuidex(   int cpuInfo[4], int function_id, int subfunction
 
 #endif // CU_ARCH_X86_64
 
+#ifdef CU_ARCH_AARCH64
+
+#include <fstream>
+
+#if  defined(__linux__)
+#include <sys/auxv.h>
+
+// older C libraries don't define the second hardware capabilities word
+#ifndef AT_HWCAP2
+#define AT_HWCAP2 26
+#endif // !AT_HWCAP2
+#endif // Linux
+
+#endif // CU_ARCH_AARCH64
+
 namespace CU {
     static constexpr auto DEFAULT_INFAM = std::numeric_limits<int>::max();
     static constexpr auto DEFAULT_INSET = std::numeric_limits<int>::max();
@@ -108,7 +128,15 @@ namespace CU {
         BEGIN_INSTRUCTIONS_FAMILY(AVX)                                    \
             ADD_INSTRACTIONS_SET( AVX,                 REG_1_0, ECX, 28 ) \
             ADD_INSTRACTIONS_SET( AVX2,                REG_7_0, EBX, 5  ) \
+            ADD_INSTRACTIONS_SET( FMA,                 REG_1_0, ECX, 12 ) \
+            ADD_INSTRACTIONS_SET( F16C,                REG_1_0, ECX, 29 ) \
         END_INSTRUCTIONS_FAMILY(AVX)                                      \
+        BEGIN_INSTRUCTIONS_FAMILY(BMI)                                    \
+            ADD_INSTRACTIONS_SET( BMI1,                REG_7_0, EBX, 3  ) \
+            ADD_INSTRACTIONS_SET( BMI2,                REG_7_0, EBX, 8  ) \
+            ADD_INSTRACTIONS_SET( LZCNT,               EXT_1_0, ECX, 5  ) \
+            ADD_INSTRACTIONS_SET( MOVBE,               REG_1_0, ECX, 22 ) \
+        END_INSTRUCTIONS_FAMILY(BMI)                                      \
         BEGIN_INSTRUCTIONS_FAMILY(AVX512)                                 \
             ADD_INSTRACTIONS_SET( AVX512F,             REG_7_0, EBX, 16 ) \
             ADD_INSTRACTIONS_SET( AVX512PF,            REG_7_0, EBX, 26 ) \
@@ -131,7 +159,40 @@ namespace CU {
         END_INSTRUCTIONS_FAMILY(AVX512)                                   \
     END_INSTRUCTIONS_FAMILIES_LIST
 
-#endif //  CU_ARCH_X86_64
+#elif defined(CU_ARCH_AARCH64)
+// see https://docs.kernel.org/arch/arm64/elf_hwcaps.html
+// the handlers are the auxiliary vector entry, its 32-bit word and the bit of the feature
+
+#define INSTRUCTIONS_SETS                                                 \
+    BEGIN_INSTRUCTIONS_FAMILIES_LIST                                      \
+        BEGIN_INSTRUCTIONS_FAMILY(NEON)                                   \
+            ADD_INSTRACTIONS_SET( NEON,           HWCAP,  AUXV_LO, 1  )   \
+            ADD_INSTRACTIONS_SET( NEON_FP16,      HWCAP,  AUXV_LO, 10 )   \
+            ADD_INSTRACTIONS_SET( NEON_RDM,       HWCAP,  AUXV_LO, 12 )   \
+            ADD_INSTRACTIONS_SET( NEON_DOTPROD,   HWCAP,  AUXV_LO, 20 )   \
+            ADD_INSTRACTIONS_SET( NEON_FHM,       HWCAP,  AUXV_LO, 23 )   \
+            ADD_INSTRACTIONS_SET( NEON_I8MM,      HWCAP2, AUXV_LO, 13 )   \
+            ADD_INSTRACTIONS_SET( NEON_BF16,      HWCAP2, AUXV_LO, 14 )   \
+        END_INSTRUCTIONS_FAMILY(NEON)                                     \
+        BEGIN_INSTRUCTIONS_FAMILY(SVE)                                    \
+            ADD_INSTRACTIONS_SET( SVE,            HWCAP,  AUXV_LO, 22 )   \
+            ADD_INSTRACTIONS_SET( SVE2,           HWCAP2, AUXV_LO, 1  )   \
+            ADD_INSTRACTIONS_SET( SVE2_BITPERM,   HWCAP2, AUXV_LO, 4  )   \
+            ADD_INSTRACTIONS_SET( SVE_I8MM,       HWCAP2, AUXV_LO, 9  )   \
+            ADD_INSTRACTIONS_SET( SVE_BF16,       HWCAP2, AUXV_LO, 12 )   \
+        END_INSTRUCTIONS_FAMILY(SVE)                                      \
+        BEGIN_INSTRUCTIONS_FAMILY(CRYPTO)                                 \
+            ADD_INSTRACTIONS_SET( AES,            HWCAP,  AUXV_LO, 3  )   \
+            ADD_INSTRACTIONS_SET( PMULL,          HWCAP,  AUXV_LO, 4  )   \
+            ADD_INSTRACTIONS_SET( SHA1,           HWCAP,  AUXV_LO, 5  )   \
+            ADD_INSTRACTIONS_SET( SHA2,           HWCAP,  AUXV_LO, 6  )   \
+            ADD_INSTRACTIONS_SET( CRC32,          HWCAP,  AUXV_LO, 7  )   \
+            ADD_INSTRACTIONS_SET( SHA3,           HWCAP,  AUXV_LO, 17 )   \
+            ADD_INSTRACTIONS_SET( SHA512,         HWCAP,  AUXV_LO, 21 )   \
+        END_INSTRUCTIONS_FAMILY(CRYPTO)                                   \
+    END_INSTRUCTIONS_FAMILIES_LIST
+
+#endif //  CU_ARCH_*
 #endif // !INSTRUCTIONS_SETS
 
 #ifndef CUSTOM_CPU_CONFIGURATION_READER
@@ -145,7 +206,7 @@ namespace CU {
 // see https://learn.microsoft.com/en-us/cpp/intrinsics/cpuid-cpuidex
 
     static inline std::string get_cpu_vendor() {
-        std::array<int, 4> cpu_descr;
+        std::array<int, 4> cpu_descr = {};
         __cpuid(cpu_descr.data(), 0);
 
         char vendor[13] = "";
@@ -164,7 +225,7 @@ namespace CU {
     }
 
     static inline std::string get_cpu_model() {
-        std::array<int, 4> cpu_descr;
+        std::array<int, 4> cpu_descr = {};
         __cpuid(cpu_descr.data(), 0x80000000);
         if (cpu_descr[0] < int(0x80000004))
             return "Not defined";
@@ -180,6 +241,60 @@ namespace CU {
 
 #endif // CU_ARCH_X86_64
 
+#ifdef  CU_ARCH_AARCH64
+// see Arm Architecture Reference Manual, "MIDR_EL1, Main ID Register"
+
+    static inline uint32_t get_cpu_midr() {
+#if defined(__linux__)
+        // the register of the first core is exported by the kernel
+        std::ifstream midr_reader("/sys/devices/system/cpu/cpu0/regs/identification/midr_el1");
+        std::string midr;
+        if (midr_reader >> midr)
+            return uint32_t(std::strtoul(midr.c_str(), nullptr, 16));
+#endif // Linux
+        return 0;
+    }
+
+    static inline std::string get_cpu_vendor() {
+        switch (get_cpu_midr() >> 24) {
+        case 0x41: return "ARM";
+        case 0x42: return "Broadcom";
+        case 0x43: return "Cavium";
+        case 0x46: return "Fujitsu";
+        case 0x48: return "HiSilicon";
+        case 0x4E: return "NVIDIA";
+        case 0x51: return "Qualcomm";
+        case 0x61: return "Apple";
+        case 0xC0: return "Ampere";
+        default:   return "Not defined";
+        }
+    }
+
+    static inline std::string get_cpu_model() {
+        const auto midr = get_cpu_midr();
+        if (!midr)
+            return "Not defined";
+
+        const auto part = (midr >> 4) & 0xFFF;
+        if (0x41 == midr >> 24) {
+            // popular server cores
+            switch (part) {
+            case 0xD0C: return "Neoverse N1";
+            case 0xD40: return "Neoverse V1";
+            case 0xD49: return "Neoverse N2";
+            case 0xD4F: return "Neoverse V2";
+            default:    break;
+            }
+        }
+
+        std::stringstream model;
+        model << "Part 0x" << std::hex << std::uppercase << part << std::dec <<
+            " r" << ((midr >> 20) & 0xF) << "p" << (midr & 0xF);
+        return model.str();
+    }
+
+#endif // CU_ARCH_AARCH64
+
 #endif // !CUSTOM_CPU_CONFIGURATION_READER
 
 // preprocessor magic works here
@@ -356,6 +471,69 @@ namespace CU {
         return DEFAULT_INSET;
     }
 
+    // Profile of instructions sets required together by a SIMD compile unit (see generate_simd_compile_units).
+    // The profile is supported if all its sets are supported.
+    struct InstructionsProfile {
+        static constexpr size_t MAX_INSETS_COUNT = 16;
+
+        const char* m_name = "";
+        InstructionsSet m_insets[MAX_INSETS_COUNT] = {};
+        size_t m_insets_count = 0;
+    };
+
+#ifdef CU_ARCH_X86_64
+    // see https://gitlab.com/x86-psABIs/x86-64-ABI, "Micro-architecture levels";
+    // the sets match the compiler flags of the profiles (see SimdAutogenerator.cmake)
+    static constexpr InstructionsProfile INSET_PROFILE_X86_64_V4 = {
+        "X86_64_V4",
+        { E_INSET_AVX2, E_INSET_FMA, E_INSET_F16C, E_INSET_BMI1, E_INSET_BMI2, E_INSET_LZCNT, E_INSET_MOVBE,
+          E_INSET_AVX512F, E_INSET_AVX512BW, E_INSET_AVX512CD, E_INSET_AVX512DQ, E_INSET_AVX512VL },
+        12
+    };
+    static constexpr InstructionsProfile INSET_PROFILE_AVX512_VNNI = {
+        "AVX512_VNNI",
+        { E_INSET_AVX2, E_INSET_FMA, E_INSET_F16C, E_INSET_BMI1, E_INSET_BMI2, E_INSET_LZCNT, E_INSET_MOVBE,
+          E_INSET_AVX512F, E_INSET_AVX512BW, E_INSET_AVX512CD, E_INSET_AVX512DQ, E_INSET_AVX512VL,
+          E_INSET_AVX512VNNI },
+        13
+    };
+    static constexpr InstructionsProfile INSET_PROFILE_AVX512_FP16 = {
+        "AVX512_FP16",
+        { E_INSET_AVX2, E_INSET_FMA, E_INSET_F16C, E_INSET_BMI1, E_INSET_BMI2, E_INSET_LZCNT, E_INSET_MOVBE,
+          E_INSET_AVX512F, E_INSET_AVX512BW, E_INSET_AVX512CD, E_INSET_AVX512DQ, E_INSET_AVX512VL,
+          E_INSET_AVX512FP16 },
+        13
+    };
+
+    static constexpr std::array INSETS_PROFILES = {
+        &INSET_PROFILE_X86_64_V4,
+        &INSET_PROFILE_AVX512_VNNI,
+        &INSET_PROFILE_AVX512_FP16,
+    };
+#else
+    static constexpr std::array<const InstructionsProfile*, 0> INSETS_PROFILES = {};
+#endif // CU_ARCH_X86_64
+
+    static inline bool is_profile_supported(const CPUConfiguration& conf, const InstructionsProfile& profile) {
+        for (size_t index = 0; index < profile.m_insets_count; index++) {
+            if (!is_inset_supported(conf, profile.m_insets[index]))
+                return false;
+        }
+        return true;
+    }
+
+    static inline bool is_profile_supported(const InstructionsProfile& profile) {
+        return is_profile_supported(CURRENT_CPU_CONFIGURATION, profile);
+    }
+
+    static inline const InstructionsProfile* get_profile_by_name(const char* profile_name) {
+        for (const auto* profile : INSETS_PROFILES) {
+            if (!std::strcmp(profile->m_name, profile_name))
+                return profile;
+        }
+        return nullptr;
+    }
+
     // Determines whether a function can be executed on the current hardware based on its postfix (e.g., _sse, _avx512, etc.).
     // WARNING: The postfix may not contain sufficient information to determine the full set of required instruction sets.
     // Use this function with caution.
@@ -366,9 +544,19 @@ namespace CU {
             return true;
         }
 
-        auto func_postfix = function_name.substr(pos + 1);
-        std::transform(func_postfix.begin(), func_postfix.end(), func_postfix.begin(),
+        auto upper_function_name = function_name;
+        std::transform(upper_function_name.begin(), upper_function_name.end(), upper_function_name.begin(),
             [](unsigned char c) { return static_cast<unsigned char>(std::toupper(c)); });
+
+        // profiles names contain underscores (e.g., _avx512_vnni)
+        for (const auto* profile : INSETS_PROFILES) {
+            const auto profile_postfix = std::string("_") + profile->m_name;
+            if (upper_function_name.size() > profile_postfix.size() &&
+                upper_function_name.ends_with(profile_postfix))
+                return is_profile_supported(*profile);
+        }
+
+        auto func_postfix = upper_function_name.substr(pos + 1);
         if (func_postfix == "DEF") {
             // it's default function
             return true;
@@ -385,4 +573,141 @@ namespace CU {
         // unknown postfix - it's regular function, we can run it
         return true;
     }
+
+    static constexpr size_t SIMD_FUNCTION_MAX_VARIANTS = 16;
+
+    // Entry point of a function compiled for several instructions sets (see generate_simd_compile_units).
+    // The best variant supported by the current CPU is resolved on the first call and cached,
+    // so the next calls cost one indirect call.
+    // Variants are expected in order of preference, the last one is usually DEFAULT_INSET.
+    template<typename Signature>
+    class SimdFunction;
+
+    template<typename Ret, typename... Args>
+    class SimdFunction<Ret(Args...)> {
+    public:
+        using Pointer = Ret(*)(Args...);
+
+        // the variant requires the set, or all the sets of the profile if it's given
+        struct Variant {
+            InstructionsSet m_inset = DEFAULT_INSET;
+            Pointer m_function = nullptr;
+            const InstructionsProfile* m_profile = nullptr;
+        };
+
+        constexpr SimdFunction(std::initializer_list<Variant> variants) {
+            for (const auto& variant : variants) {
+                if (m_variants_count < SIMD_FUNCTION_MAX_VARIANTS)
+                    m_variants[m_variants_count++] = variant;
+            }
+        }
+
+        SimdFunction(const SimdFunction&) = delete;
+        SimdFunction(SimdFunction&&) = delete;
+        SimdFunction& operator=(const SimdFunction&) = delete;
+        SimdFunction& operator=(SimdFunction&&) = delete;
+
+        // throws std::runtime_error if none of the variants is supported by the current CPU
+        // (never happens if there is a DEFAULT_INSET variant)
+        Ret operator()(Args... args) const {
+            auto function = m_selected.load(std::memory_order_relaxed);
+            if (!function) [[unlikely]]
+                function = Resolve();
+            return function(std::forward<Args>(args)...);
+        }
+
+        // returns the variant for the given set if it's supported by the current CPU,
+        // AUTO_INSET - the best supported variant (including variants of profiles)
+        Pointer Get(InstructionsSet inset = AUTO_INSET) const {
+            const auto* variant = Find(inset);
+            return variant ? variant->m_function : nullptr;
+        }
+
+        // returns the variant for the given profile if it's supported by the current CPU
+        Pointer Get(const InstructionsProfile& profile) const {
+            for (size_t index = 0; index < m_variants_count; index++) {
+                const auto& variant = m_variants[index];
+                if (variant.m_profile == &profile && IsSupported(variant))
+                    return variant.m_function;
+            }
+            return nullptr;
+        }
+
+        // returns the profile of the variant used by operator(), nullptr if it requires a single set
+        const InstructionsProfile* GetProfile() const {
+            const auto* variant = Find(AUTO_INSET);
+            return variant ? variant->m_profile : nullptr;
+        }
+
+        // returns the set of the variant used by operator()
+        InstructionsSet GetInset() const {
+            const auto* variant = Find(AUTO_INSET);
+            return variant ? variant->m_inset : DEFAULT_INSET;
+        }
+
+    private:
+        static bool IsSupported(const Variant& variant) {
+            if (variant.m_profile)
+                return is_profile_supported(*variant.m_profile);
+            return DEFAULT_INSET == variant.m_inset || is_inset_supported(variant.m_inset);
+        }
+
+        const Variant* Find(InstructionsSet inset) const {
+            for (size_t index = 0; index < m_variants_count; index++) {
+                const auto& variant = m_variants[index];
+                // variants of profiles are requested by profiles only
+                if (AUTO_INSET != inset && (variant.m_profile || variant.m_inset != inset))
+                    continue;
+                if (IsSupported(variant))
+                    return &variant;
+            }
+            return nullptr;
+        }
+
+        Pointer Resolve() const {
+            const auto function = Get(AUTO_INSET);
+            if (!function)
+                throw std::runtime_error("Supported implementation of SIMD function not found");
+
+            m_selected.store(function, std::memory_order_relaxed);
+            return function;
+        }
+
+        Variant m_variants[SIMD_FUNCTION_MAX_VARIANTS] = {};
+        size_t m_variants_count = 0;
+        mutable std::atomic<Pointer> m_selected = nullptr;
+    };
+
+    // Time Stamp Counter features.
+    // They aren't instructions sets, so they are not the part of CPUConfiguration.
+
+    static inline bool is_rdtscp_supported() {
+#ifdef CU_ARCH_X86_64
+        std::array<int, 4> cpu_descr = {};
+        __cpuid(cpu_descr.data(), 0x80000000);
+        if (cpu_descr[0] < int(0x80000001))
+            return false;
+
+        __cpuidex(cpu_descr.data(), 0x80000001, 0);
+        return cpu_descr[3] & (1 << 27);
+#else
+        return false;
+#endif // CU_ARCH_X86_64
+    }
+
+    // Invariant TSC runs at a constant rate in all ACPI P-, C- and T-states,
+    // so it can be used as a wall clock (see Intel SDM, Vol. 3B, "Invariant TSC")
+    static inline bool is_invariant_tsc_supported() {
+#ifdef CU_ARCH_X86_64
+        std::array<int, 4> cpu_descr = {};
+        __cpuid(cpu_descr.data(), 0x80000000);
+        if (cpu_descr[0] < int(0x80000007))
+            return false;
+
+        __cpuidex(cpu_descr.data(), 0x80000007, 0);
+        return cpu_descr[3] & (1 << 8);
+#else
+        return false;
+#endif // CU_ARCH_X86_64
+    }
 }
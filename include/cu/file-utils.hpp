@@ -12,6 +12,21 @@
 #include <vector>
 #include <cstring>
 #include <ranges>
+#include <span>
+#include <utility>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <charconv>
+#include <bit>
+#include <string_view>
+#include <array>
+#include <type_traits>
 
 #if defined(_WIN32)
 #define NOMINMAX
@@ -22,6 +37,13 @@
 #include <dlfcn.h>
 #include <unistd.h>
 #include <linux/limits.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(CU_ARCH_X86_64)
+#include <emmintrin.h>
 #endif
 
 namespace CU {
@@ -106,44 +128,650 @@ namespace CU {
         return result;
     }
 
+    // expected access pattern to the memory mapped file, used as a hint for the OS
+    enum class MappedFileAccess {
+        NORMAL,
+        SEQUENTIAL,
+        RANDOM,
+        WILL_NEED    // the whole file will be used soon, read it ahead
+    };
+
+    // Read-only memory mapped view of a binary file as an array of units.
+    // Pages are loaded on demand, so opening is O(1) and the data is shared with the page cache.
+    // An empty view is returned on any error (same as load_data_from_file).
     template<typename Unit>
     requires std::is_fundamental_v<Unit>
-    std::vector<Unit> load_data_from_text_file(const std::filesystem::path& file_name) {
-        // TODO: support delimiter
-        if (!std::filesystem::exists(file_name)) {
-            // TODO: use log system, instead of stdout
-            std::cout << "selected file " << file_name << " doesn't exist" << std::endl;
-            return {};
+    class MappedFileView {
+    public:
+        using value_type     = Unit;
+        using const_iterator = const Unit*;
+
+        MappedFileView() = default;
+
+        explicit MappedFileView(
+                const std::filesystem::path& file_name,
+                MappedFileAccess access = MappedFileAccess::SEQUENTIAL) {
+            if (!std::filesystem::exists(file_name)) {
+                // TODO: use log system, instead of stdout
+                std::cout << "selected file " << file_name << " doesn't exist" << std::endl;
+                return;
+            }
+
+            std::error_code error;
+            const auto file_size = std::filesystem::file_size(file_name, error);
+            if (error) {
+                // TODO: use log system, instead of stdout
+                std::cout << "failed get size of file " << file_name << std::endl;
+                return;
+            }
+            if (file_size % sizeof(Unit)) {
+                // TODO: use log system, instead of stdout
+                std::cout << "file size " << file_size <<
+                    " is not a multiple of the unit size " << sizeof(Unit) << std::endl;
+            }
+            if (file_size < sizeof(Unit))
+                return;
+
+            if (!Map(file_name, file_size))
+                return;
+
+            if (reinterpret_cast<std::uintptr_t>(m_mapping) % alignof(Unit)) {
+                // TODO: use log system, instead of stdout
+                std::cout << "file " << file_name << " is mapped with invalid alignment" << std::endl;
+                Unmap();
+                return;
+            }
+
+            m_units_count = file_size / sizeof(Unit);
+            Advise(access);
         }
 
-        std::ifstream file_reader{ file_name };
-        if (!file_reader) {
-            // TODO: use log system, instead of stdout
-            std::cout << "failed open file " << file_name << std::endl;
-            return {};
+        MappedFileView(const MappedFileView&) = delete;
+        MappedFileView& operator=(const MappedFileView&) = delete;
+
+        MappedFileView(MappedFileView&& other) noexcept :
+            m_mapping{ std::exchange(other.m_mapping, nullptr) },
+            m_mapping_size{ std::exchange(other.m_mapping_size, 0) },
+            m_units_count{ std::exchange(other.m_units_count, 0) } {
         }
 
-        std::vector<Unit> result;
-        Unit value;
-        while (!file_reader.eof() && !file_reader.fail()) {
-            while (file_reader >> value) {
-                result.push_back(value);
+        MappedFileView& operator=(MappedFileView&& other) noexcept {
+            if (this != &other) {
+                Unmap();
+                m_mapping = std::exchange(other.m_mapping, nullptr);
+                m_mapping_size = std::exchange(other.m_mapping_size, 0);
+                m_units_count = std::exchange(other.m_units_count, 0);
+            }
+            return *this;
+        }
+
+        ~MappedFileView() {
+            Unmap();
+        }
+
+        // changes the hint of the expected access pattern
+        void Advise(MappedFileAccess access) const {
+#if defined(__linux__)
+            if (!m_mapping)
+                return;
+
+            int advice = MADV_NORMAL;
+            switch (access) {
+            case MappedFileAccess::SEQUENTIAL:
+                advice = MADV_SEQUENTIAL;
+                break;
+            case MappedFileAccess::RANDOM:
+                advice = MADV_RANDOM;
+                break;
+            case MappedFileAccess::WILL_NEED:
+                advice = MADV_WILLNEED;
+                break;
+            default:
+                break;
+            }
+            madvise(m_mapping, m_mapping_size, advice);
+#else
+            (void)access;
+#endif // __linux__
+        }
+
+        const Unit* data() const { return static_cast<const Unit*>(m_mapping); }
+        size_t size() const { return m_units_count; }
+        bool empty() const { return m_units_count == 0; }
+
+        const_iterator begin() const { return data(); }
+        const_iterator end() const { return data() + m_units_count; }
+
+        const Unit& operator[](size_t index) const { return data()[index]; }
+
+        std::span<const Unit> as_span() const { return { data(), m_units_count }; }
+
+    private:
+        bool Map(const std::filesystem::path& file_name, size_t file_size) {
+#if defined(_WIN32)
+            HANDLE file = CreateFileW(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) {
+                // TODO: use log system, instead of stdout
+                std::cout << "failed open file " << file_name << std::endl;
+                return false;
+            }
+
+            HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            CloseHandle(file);
+            if (!mapping) {
+                // TODO: use log system, instead of stdout
+                std::cout << "failed map file " << file_name << std::endl;
+                return false;
+            }
+
+            m_mapping = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+#elif defined(__linux__)
+            const int file = open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+            if (file < 0) {
+                // TODO: use log system, instead of stdout
+                std::cout << "failed open file " << file_name << std::endl;
+                return false;
+            }
+
+            void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, file, 0);
+            close(file);
+            m_mapping = mapping == MAP_FAILED ? nullptr : mapping;
+#else
+            static_assert(!"Unsupported OS");
+#endif // _WIN32
+
+            if (!m_mapping) {
+                // TODO: use log system, instead of stdout
+                std::cout << "failed map file " << file_name << std::endl;
+                return false;
             }
 
-            if (file_reader.fail() && !file_reader.eof()) {
-                file_reader.clear();
+            m_mapping_size = file_size;
+            return true;
+        }
+
+        void Unmap() {
+            if (!m_mapping)
+                return;
 
-                std::string bad_part;
-                file_reader >> bad_part;
+#if defined(_WIN32)
+            UnmapViewOfFile(m_mapping);
+#elif defined(__linux__)
+            munmap(m_mapping, m_mapping_size);
+#endif // _WIN32
+
+            m_mapping = nullptr;
+            m_mapping_size = 0;
+            m_units_count = 0;
+        }
 
+        void*  m_mapping = nullptr;
+        size_t m_mapping_size = 0;
+        size_t m_units_count = 0;
+    };
+
+    // zero-copy alternative of load_data_from_file
+    template<typename Unit>
+    requires std::is_fundamental_v<Unit>
+    MappedFileView<Unit> map_data_from_file(
+            const std::filesystem::path& file_name,
+            MappedFileAccess access = MappedFileAccess::SEQUENTIAL) {
+        return MappedFileView<Unit>(file_name, access);
+    }
+
+    namespace PrivateImplementation {
+        // chunks are aligned for any SIMD instruction set
+        constexpr inline size_t CHUNK_ALIGNMENT = 64;
+
+        struct ChunkDeleter {
+            void operator()(void* chunk) const {
+                ::operator delete(chunk, std::align_val_t{ CHUNK_ALIGNMENT });
+            }
+        };
+
+        template<typename Unit>
+        std::unique_ptr<Unit[], ChunkDeleter> allocate_chunk(size_t units_count) {
+            const auto bytes_count = (units_count * sizeof(Unit) + CHUNK_ALIGNMENT - 1) / CHUNK_ALIGNMENT * CHUNK_ALIGNMENT;
+            return std::unique_ptr<Unit[], ChunkDeleter>(
+                static_cast<Unit*>(::operator new(bytes_count, std::align_val_t{ CHUNK_ALIGNMENT })));
+        }
+    } // namespace PrivateImplementation
+
+    constexpr inline size_t DEFAULT_CHUNK_BYTES = 4 * 1024 * 1024;
+
+    // Reads a binary file by fixed-size aligned chunks.
+    // The next chunk is read on the background thread while the current one is processed,
+    // so memory usage is bounded by two chunks regardless of the file size.
+    template<typename Unit>
+    requires std::is_fundamental_v<Unit>
+    class ChunkedFileReader {
+    public:
+        explicit ChunkedFileReader(
+                const std::filesystem::path& file_name,
+                size_t chunk_units_count = DEFAULT_CHUNK_BYTES / sizeof(Unit)) :
+            m_chunk_units_count{ std::max<size_t>(chunk_units_count, 1) } {
+            m_file_reader.open(file_name, std::ios::binary);
+            if (!m_file_reader) {
                 // TODO: use log system, instead of stdout
-                std::cout << "error when read file, skip unsupported block '" << bad_part << "'" << std::endl;
+                std::cout << "failed open file " << file_name << std::endl;
+                m_is_failed = true;
+                return;
             }
+
+            for (auto& chunk : m_chunks) {
+                chunk = PrivateImplementation::allocate_chunk<Unit>(m_chunk_units_count);
+            }
+            m_read_thread = std::thread(&ChunkedFileReader::ReadAhead, this);
+        }
+
+        ChunkedFileReader(const ChunkedFileReader&) = delete;
+        ChunkedFileReader(ChunkedFileReader&&) = delete;
+        ChunkedFileReader& operator=(const ChunkedFileReader&) = delete;
+        ChunkedFileReader& operator=(ChunkedFileReader&&) = delete;
+
+        ~ChunkedFileReader() {
+            {
+                std::lock_guard lock{ m_mutex };
+                m_is_stopped = true;
+            }
+            m_condition.notify_all();
+            if (m_read_thread.joinable())
+                m_read_thread.join();
+        }
+
+        // returns the next chunk, which is valid until the next call;
+        // an empty chunk means the end of the file or an error (see IsFailed)
+        std::span<const Unit> Next() {
+            if (!m_read_thread.joinable())
+                return {};
+
+            std::unique_lock lock{ m_mutex };
+            if (m_current_chunk >= 0) {
+                // the previous chunk is processed, it can be refilled
+                m_is_ready[m_current_chunk] = false;
+                m_condition.notify_all();
+            }
+
+            m_current_chunk = m_next_chunk;
+            m_condition.wait(lock, [this] { return m_is_ready[m_current_chunk]; });
+            if (!m_sizes[m_current_chunk]) {
+                // the end of the file, keep the chunk ready for subsequent calls
+                m_next_chunk = m_current_chunk;
+                m_current_chunk = -1;
+                return {};
+            }
+
+            m_next_chunk = m_current_chunk ^ 1;
+            return { m_chunks[m_current_chunk].get(), m_sizes[m_current_chunk] };
+        }
+
+        bool IsFailed() const {
+            std::lock_guard lock{ m_mutex };
+            return m_is_failed;
+        }
+
+    private:
+        void ReadAhead() {
+            for (int chunk_index = 0; ; chunk_index ^= 1) {
+                {
+                    std::unique_lock lock{ m_mutex };
+                    m_condition.wait(lock, [&] { return m_is_stopped || !m_is_ready[chunk_index]; });
+                    if (m_is_stopped)
+                        return;
+                }
+
+                m_file_reader.read(reinterpret_cast<char*>(m_chunks[chunk_index].get()),
+                                   std::streamsize(m_chunk_units_count * sizeof(Unit)));
+                const auto bytes_count = size_t(m_file_reader.gcount());
+                const bool is_read_error = m_file_reader.bad();
+                if (bytes_count % sizeof(Unit)) {
+                    // TODO: use log system, instead of stdout
+                    std::cout << "file size is not a multiple of the unit size " << sizeof(Unit) << std::endl;
+                }
+
+                std::lock_guard lock{ m_mutex };
+                m_sizes[chunk_index] = is_read_error ? 0 : bytes_count / sizeof(Unit);
+                m_is_ready[chunk_index] = true;
+                m_is_failed = is_read_error;
+                m_condition.notify_all();
+                if (!m_sizes[chunk_index])
+                    return;
+            }
+        }
+
+        const size_t m_chunk_units_count;
+        std::ifstream m_file_reader;
+        std::unique_ptr<Unit[], PrivateImplementation::ChunkDeleter> m_chunks[2];
+        size_t m_sizes[2] = { 0, 0 };
+        bool m_is_ready[2] = { false, false };
+        bool m_is_stopped = false;
+        bool m_is_failed = false;
+        int m_current_chunk = -1;
+        int m_next_chunk = 0;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::thread m_read_thread;
+    };
+
+    // Writes a binary file by fixed-size aligned chunks.
+    // A filled chunk is written on the background thread while the next one is filled.
+    template<typename Unit>
+    requires std::is_fundamental_v<Unit>
+    class ChunkedFileWriter {
+    public:
+        explicit ChunkedFileWriter(
+                const std::filesystem::path& file_name,
+                size_t chunk_units_count = DEFAULT_CHUNK_BYTES / sizeof(Unit)) :
+            m_chunk_units_count{ std::max<size_t>(chunk_units_count, 1) } {
+            m_file_writer.open(file_name, std::ios::binary);
+            if (!m_file_writer) {
+                // TODO: use log system, instead of stdout
+                std::cout << "failed open file " << file_name << std::endl;
+                m_is_failed = true;
+                return;
+            }
+
+            for (auto& chunk : m_chunks) {
+                chunk = PrivateImplementation::allocate_chunk<Unit>(m_chunk_units_count);
+            }
+            m_write_thread = std::thread(&ChunkedFileWriter::WriteBehind, this);
+        }
+
+        ChunkedFileWriter(const ChunkedFileWriter&) = delete;
+        ChunkedFileWriter(ChunkedFileWriter&&) = delete;
+        ChunkedFileWriter& operator=(const ChunkedFileWriter&) = delete;
+        ChunkedFileWriter& operator=(ChunkedFileWriter&&) = delete;
+
+        ~ChunkedFileWriter() {
+            Flush();
+            {
+                std::lock_guard lock{ m_mutex };
+                m_is_stopped = true;
+            }
+            m_condition.notify_all();
+            if (m_write_thread.joinable())
+                m_write_thread.join();
+        }
+
+        // returns the free part of the current chunk to be filled in place, see Commit
+        std::span<Unit> GetChunk() {
+            if (!m_write_thread.joinable())
+                return {};
+            return { m_chunks[m_current_chunk].get() + m_current_size, m_chunk_units_count - m_current_size };
+        }
+
+        // appends units_count units filled in the span returned by GetChunk
+        bool Commit(size_t units_count) {
+            if (!m_write_thread.joinable())
+                return false;
+
+            m_current_size += std::min(units_count, m_chunk_units_count - m_current_size);
+            if (m_current_size == m_chunk_units_count)
+                return Submit();
+            return true;
+        }
+
+        bool Write(std::span<const Unit> values) {
+            while (!values.empty()) {
+                const auto chunk = GetChunk();
+                if (chunk.empty())
+                    return false;
+
+                const auto units_count = std::min(chunk.size(), values.size());
+                std::copy_n(values.begin(), units_count, chunk.begin());
+                values = values.subspan(units_count);
+                if (!Commit(units_count))
+                    return false;
+            }
+            return true;
+        }
+
+        // writes all the committed units and waits for completion
+        bool Flush() {
+            if (!m_write_thread.joinable())
+                return false;
+            if (m_current_size && !Submit())
+                return false;
+
+            std::unique_lock lock{ m_mutex };
+            m_condition.wait(lock, [this] { return m_pending_chunk < 0; });
+            if (!m_is_failed && !m_file_writer.flush())
+                m_is_failed = true;
+            return !m_is_failed;
+        }
+
+        bool IsFailed() const {
+            std::lock_guard lock{ m_mutex };
+            return m_is_failed;
+        }
+
+    private:
+        bool Submit() {
+            std::unique_lock lock{ m_mutex };
+            m_condition.wait(lock, [this] { return m_pending_chunk < 0; });
+            if (m_is_failed)
+                return false;
+
+            m_pending_chunk = m_current_chunk;
+            m_pending_size = m_current_size;
+            m_condition.notify_all();
+
+            m_current_chunk ^= 1;
+            m_current_size = 0;
+            return true;
+        }
+
+        void WriteBehind() {
+            while (true) {
+                int chunk_index;
+                size_t units_count;
+                {
+                    std::unique_lock lock{ m_mutex };
+                    m_condition.wait(lock, [this] { return m_is_stopped || m_pending_chunk >= 0; });
+                    if (m_pending_chunk < 0)
+                        return;
+                    chunk_index = m_pending_chunk;
+                    units_count = m_pending_size;
+                }
+
+                const bool is_written = bool(m_file_writer.write(
+                    reinterpret_cast<const char*>(m_chunks[chunk_index].get()),
+                    std::streamsize(units_count * sizeof(Unit))));
+                if (!is_written) {
+                    // TODO: use log system, instead of stdout
+                    std::cout << "chunked file - write error" << std::endl;
+                }
+
+                std::lock_guard lock{ m_mutex };
+                m_is_failed = m_is_failed || !is_written;
+                m_pending_chunk = -1;
+                m_condition.notify_all();
+            }
+        }
+
+        const size_t m_chunk_units_count;
+        std::ofstream m_file_writer;
+        std::unique_ptr<Unit[], PrivateImplementation::ChunkDeleter> m_chunks[2];
+        int m_current_chunk = 0;
+        size_t m_current_size = 0;
+        int m_pending_chunk = -1;
+        size_t m_pending_size = 0;
+        bool m_is_stopped = false;
+        bool m_is_failed = false;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::thread m_write_thread;
+    };
+
+    // streams the input file through the function by chunks, so I/O overlaps the computation;
+    // the function has the signature of test functions: (input, units count, output)
+    template<typename Unit>
+    requires std::is_fundamental_v<Unit>
+    bool transform_file_by_chunks(
+            const std::filesystem::path& input_file_name,
+            const std::filesystem::path& output_file_name,
+            const std::function<void(const Unit*, int64_t, Unit*)>& function,
+            size_t chunk_units_count = DEFAULT_CHUNK_BYTES / sizeof(Unit)) {
+        ChunkedFileReader<Unit> reader{ input_file_name, chunk_units_count };
+        // the output file isn't created if the input can't be read
+        if (reader.IsFailed())
+            return false;
+
+        ChunkedFileWriter<Unit> writer{ output_file_name, chunk_units_count };
+
+        for (auto chunk = reader.Next(); !chunk.empty(); chunk = reader.Next()) {
+            const auto output = writer.GetChunk();
+            if (output.size() < chunk.size())
+                return false;
+
+            function(chunk.data(), int64_t(chunk.size()), output.data());
+            if (!writer.Commit(chunk.size()))
+                return false;
+        }
+
+        return !reader.IsFailed() && writer.Flush();
+    }
+
+    // whitespaces are always delimiters of text data, other delimiters are added to them
+    constexpr inline std::string_view TEXT_WHITESPACES = " \t\n\v\f\r";
+
+    namespace PrivateImplementation {
+        class TextDelimiters {
+        public:
+            explicit TextDelimiters(std::string_view delimiters) {
+                for (const auto symbols : { TEXT_WHITESPACES, delimiters }) {
+                    for (const auto symbol : symbols) {
+                        auto& is_delimiter = m_table[static_cast<unsigned char>(symbol)];
+#if defined(CU_ARCH_X86_64)
+                        if (!is_delimiter && m_vectors_count < std::size(m_vectors))
+                            m_vectors[m_vectors_count++] = _mm_set1_epi8(symbol);
+                        else if (!is_delimiter)
+                            m_is_vector_search = false;
+#endif // CU_ARCH_X86_64
+                        is_delimiter = true;
+                    }
+                }
+            }
+
+            bool IsDelimiter(char symbol) const {
+                return m_table[static_cast<unsigned char>(symbol)];
+            }
+
+            const char* SkipDelimiters(const char* begin, const char* end) const {
+                while (begin != end && IsDelimiter(*begin))
+                    begin++;
+                return begin;
+            }
+
+            const char* FindDelimiter(const char* begin, const char* end) const {
+#if defined(CU_ARCH_X86_64)
+                // compare 16 symbols with every delimiter at once
+                constexpr size_t step = sizeof(__m128i);
+                if (m_is_vector_search) {
+                    for (; size_t(end - begin) >= step; begin += step) {
+                        const auto symbols = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+                        auto matches = _mm_setzero_si128();
+                        for (size_t i = 0; i < m_vectors_count; i++) {
+                            matches = _mm_or_si128(matches, _mm_cmpeq_epi8(symbols, m_vectors[i]));
+                        }
+
+                        const auto mask = unsigned(_mm_movemask_epi8(matches));
+                        if (mask)
+                            return begin + std::countr_zero(mask);
+                    }
+                }
+#endif // CU_ARCH_X86_64
+                while (begin != end && !IsDelimiter(*begin))
+                    begin++;
+                return begin;
+            }
+
+        private:
+            std::array<bool, 256> m_table = {};
+#if defined(CU_ARCH_X86_64)
+            __m128i m_vectors[16] = {};
+            size_t m_vectors_count = 0;
+            bool m_is_vector_search = true;
+#endif // CU_ARCH_X86_64
+        };
+
+        template<typename Unit>
+        constexpr inline bool IS_CHARACTER_UNIT =
+            std::is_same_v<Unit, char> || std::is_same_v<Unit, signed char> || std::is_same_v<Unit, unsigned char>;
+
+        // parses the value from the beginning of the text like operator>>
+        template<typename Unit>
+        std::from_chars_result parse_text_value(const char* begin, const char* end, Unit& value) {
+            // operator>> accepts the explicit plus sign
+            if (end - begin > 1 && *begin == '+' && begin[1] != '-' && begin[1] != '+')
+                begin++;
+
+            if constexpr (std::is_same_v<Unit, bool>) {
+                unsigned number = 0;
+                auto result = std::from_chars(begin, end, number);
+                if (result.ec == std::errc{} && number > 1)
+                    return { begin, std::errc::invalid_argument };
+                value = number;
+                return result;
+            }
+            else {
+                return std::from_chars(begin, end, value);
+            }
+        }
+    } // namespace PrivateImplementation
+
+    // parses values separated by whitespaces and the given delimiters;
+    // unsupported parts of the text are skipped and reported
+    template<typename Unit>
+    requires std::is_arithmetic_v<Unit>
+    std::vector<Unit> parse_text_data(std::string_view text, std::string_view delimiters = {}) {
+        const PrivateImplementation::TextDelimiters text_delimiters{ delimiters };
+        const char* position = text.data();
+        const char* const text_end = text.data() + text.size();
+
+        std::vector<Unit> result;
+        while (true) {
+            position = text_delimiters.SkipDelimiters(position, text_end);
+            if (position == text_end)
+                break;
+
+            const char* const token_end = text_delimiters.FindDelimiter(position, text_end);
+            if constexpr (PrivateImplementation::IS_CHARACTER_UNIT<Unit>) {
+                // operator>> reads characters one by one
+                result.insert(result.end(), position, token_end);
+                position = token_end;
+            }
+
+            // a token may contain several values (e.g. "1-2"), as operator>> reads it
+            while (position != token_end) {
+                Unit value;
+                const auto [parsed_end, error] = PrivateImplementation::parse_text_value(position, token_end, value);
+                if (error != std::errc{}) {
+                    // TODO: use log system, instead of stdout
+                    std::cout << "error when read file, skip unsupported block '" <<
+                        std::string_view(position, token_end) << "'" << std::endl;
+                    break;
+                }
+
+                result.push_back(value);
+                position = parsed_end;
+            }
+            position = token_end;
         }
 
         return result;
     }
 
+    template<typename Unit>
+    requires std::is_arithmetic_v<Unit>
+    std::vector<Unit> load_data_from_text_file(const std::filesystem::path& file_name, std::string_view delimiters = {}) {
+        // the text isn't copied, values are parsed directly from the mapped file
+        const auto text = map_data_from_file<char>(file_name, MappedFileAccess::SEQUENTIAL);
+        return parse_text_data<Unit>(std::string_view(text.data(), text.size()), delimiters);
+    }
+
     template <typename T>
     concept FundamentalContainer = requires(T c) {
         typename T::value_type;
@@ -173,8 +801,91 @@ namespace CU {
         return true;
     }
 
+    struct TextWriterConfiguration {
+        // written after every value
+        std::string_view m_delimiter = "\n";
+        // precision of floating-point values, 6 is the default one of streams
+        int m_precision = 6;
+        // the shortest representation of floating-point values that is read back exactly, m_precision is ignored
+        bool m_is_shortest = false;
+        // large arrays are formatted by several threads, 0 - all hardware threads
+        size_t m_threads_count = 1;
+        size_t m_min_values_per_thread = 1 << 16;
+    };
+
+    namespace PrivateImplementation {
+        constexpr inline size_t TEXT_BLOCK_SIZE = 1024 * 1024;
+
+        // formats the value followed by the delimiter like operator<<, returns nullptr if there is no space
+        template<typename Unit>
+        char* format_text_value(char* first, char* last, Unit value, const TextWriterConfiguration& configuration) {
+            if constexpr (IS_CHARACTER_UNIT<Unit>) {
+                if (first == last)
+                    return nullptr;
+                *first++ = static_cast<char>(value);
+            }
+            else {
+                std::to_chars_result result;
+                if constexpr (std::is_same_v<Unit, bool>) {
+                    result = std::to_chars(first, last, int(value));
+                }
+                else if constexpr (std::is_floating_point_v<Unit>) {
+                    result = configuration.m_is_shortest ?
+                        std::to_chars(first, last, value) :
+                        std::to_chars(first, last, value, std::chars_format::general, configuration.m_precision);
+                }
+                else {
+                    result = std::to_chars(first, last, value);
+                }
+
+                if (result.ec != std::errc{})
+                    return nullptr;
+                first = result.ptr;
+            }
+
+            const auto& delimiter = configuration.m_delimiter;
+            if (size_t(last - first) < delimiter.size())
+                return nullptr;
+            return std::copy(delimiter.begin(), delimiter.end(), first);
+        }
+
+        // formats values into blocks of text, the full blocks are passed to write_block
+        template<typename Unit, typename BlockWriter>
+        bool format_text_values(std::span<const Unit> values, const TextWriterConfiguration& configuration,
+                                BlockWriter&& write_block) {
+            std::string block(std::min(TEXT_BLOCK_SIZE, values.size() * 32 + 64), '\0');
+            size_t block_size = 0;
+            for (const auto& value : values) {
+                while (true) {
+                    const auto value_end = format_text_value(
+                        block.data() + block_size, block.data() + block.size(), value, configuration);
+                    if (value_end) {
+                        block_size = size_t(value_end - block.data());
+                        break;
+                    }
+
+                    if (block_size) {
+                        if (!write_block(std::string_view(block.data(), block_size)))
+                            return false;
+                        block_size = 0;
+                    }
+                    else {
+                        // the value doesn't fit an empty block (e.g. huge precision)
+                        block.resize(block.size() * 2);
+                    }
+                }
+            }
+
+            return !block_size || write_block(std::string_view(block.data(), block_size));
+        }
+    } // namespace PrivateImplementation
+
+    // writes values in the same format as operator<< followed by the delimiter
     template<FundamentalContainer Container>
-    bool save_data_to_text_file(const std::filesystem::path& file_name, const Container& values) {
+    bool save_data_to_text_file(const std::filesystem::path& file_name, const Container& values,
+                                const TextWriterConfiguration& configuration = {}) {
+        using Unit = typename Container::value_type;
+
         std::ofstream file_writer{ file_name };
         if (!file_writer) {
             // TODO: use log system, instead of stdout
@@ -182,13 +893,47 @@ namespace CU {
             return false;
         }
 
-        for (const auto& value : values) {
-            file_writer << value << std::endl;
-            if (!file_writer) {
-                // TODO: use log system, instead of stdout
-                std::cout << "file " << file_name << " - write error" << std::endl;
-                return false;
+        const std::span<const Unit> units{ values.data(), values.size() };
+        const auto write_block = [&](std::string_view block) {
+            return bool(file_writer.write(block.data(), std::streamsize(block.size())));
+        };
+
+        auto threads_count = configuration.m_threads_count ?
+            configuration.m_threads_count : size_t(std::max(std::thread::hardware_concurrency(), 1u));
+        threads_count = std::clamp<size_t>(
+            units.size() / std::max<size_t>(configuration.m_min_values_per_thread, 1), 1, threads_count);
+
+        bool is_written = true;
+        if (threads_count == 1) {
+            is_written = PrivateImplementation::format_text_values(units, configuration, write_block);
+        }
+        else {
+            // every thread formats its part of values, the parts are written in order
+            std::vector<std::string> parts(threads_count);
+            std::vector<std::thread> threads;
+            const auto part_size = (units.size() + threads_count - 1) / threads_count;
+            for (size_t index = 0; index < threads_count; index++) {
+                threads.emplace_back([&, index] {
+                    const auto part_begin = std::min(index * part_size, units.size());
+                    const auto part_units = units.subspan(part_begin, std::min(part_size, units.size() - part_begin));
+                    PrivateImplementation::format_text_values(part_units, configuration, [&](std::string_view block) {
+                        parts[index].append(block);
+                        return true;
+                    });
+                });
             }
+
+            for (size_t index = 0; index < threads_count; index++) {
+                threads[index].join();
+                is_written = is_written && write_block(parts[index]);
+                parts[index] = {};
+            }
+        }
+
+        if (!is_written || !file_writer.flush()) {
+            // TODO: use log system, instead of stdout
+            std::cout << "file " << file_name << " - write error" << std::endl;
+            return false;
         }
 
         return true;
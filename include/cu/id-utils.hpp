@@ -11,18 +11,32 @@
 #ifndef CU_UID_TYPE
 #  define CU_UID_TYPE uint64_t
 #endif // !CU_UID_TYPE
+// CU_UID_THREAD_BLOCK_SIZE - if defined, get_uid reserves blocks of this size for every thread
+// (see UidGeneratorT::GetFromThreadBlock)
+// CU_UID_SNOWFLAKE - if defined, get_uid returns time-ordered UIDs unique across workers
+// (see SnowflakeUidGenerator, requires 64-bit CU_UID_TYPE)
 
 #include <stdint.h>
 #include <concepts>
 #include <mutex>
 #include <limits>
 #include <string>
-#include <sstream>
-#include <iomanip>
 #include <cassert>
 #include <stdexcept>
 #include <charconv>
 #include <set>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <bit>
+#include <type_traits>
+#include <utility>
+#include <tuple>
+#include <span>
+#include <string_view>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
 
 namespace CU {
     using id_t = CU_ID_TYPE;
@@ -78,6 +92,368 @@ namespace CU {
 
     using IdPool = IdPoolT<CU_ID_TYPE>;
 
+    // Pool of identifiers with the same semantics as IdPoolT (the smallest free identifier is locked first),
+    // free identifiers are stored by one bit per identifier.
+    // Every next level of the bitmap marks non-empty words of the previous level, so the smallest free identifier
+    // is found by a single trailing zeros count (tzcnt) per level, the pool is shrunk by leading ones count (lzcnt).
+    template<std::unsigned_integral ID_T>
+    class BitmapIdPoolT {
+    public:
+        ID_T LockId() {
+            if (m_available_count) {
+                const auto id = FindLowestAvailable();
+                ClearBits(id, 1);
+                m_available_count--;
+                return id;
+            }
+
+            assert(INVALID_ID != m_max_id);
+            Reserve(size_t(m_max_id) + 1);
+            return m_max_id++;
+        }
+
+        bool CheckId(ID_T id) const {
+            return (id < m_max_id) && !(m_levels[0][id / WORD_BITS] & (uint64_t(1) << (id % WORD_BITS)));
+        }
+
+        void FreeId(ID_T id) {
+            assert(CheckId(id));
+
+            if ((m_max_id - 1) == id) {
+                m_max_id--;
+                ClearAvailable();
+                return;
+            }
+
+            SetBit(id);
+            m_available_count++;
+        }
+
+    private:
+        static constexpr size_t WORD_BITS = 64;
+
+        // removes free identifiers from the end of the range
+        void ClearAvailable() {
+            while (m_available_count) {
+                const auto last_id = size_t(m_max_id) - 1;
+                const auto shift = WORD_BITS - 1 - last_id % WORD_BITS;
+                // free identifiers preceding m_max_id within the word
+                const auto free_count = size_t(std::countl_one(m_levels[0][last_id / WORD_BITS] << shift));
+                if (!free_count)
+                    return;
+
+                const auto cleared_count = std::min(free_count, last_id % WORD_BITS + 1);
+                ClearBits(ID_T(last_id + 1 - cleared_count), cleared_count);
+                m_max_id = ID_T(m_max_id - cleared_count);
+                m_available_count -= cleared_count;
+            }
+        }
+
+        ID_T FindLowestAvailable() const {
+            size_t index = 0;
+            for (size_t level = m_levels.size(); level-- > 0;) {
+                index = index * WORD_BITS + size_t(std::countr_zero(m_levels[level][index]));
+            }
+            return ID_T(index);
+        }
+
+        void SetBit(size_t index) {
+            for (auto& level : m_levels) {
+                auto& word = level[index / WORD_BITS];
+                const bool was_empty = !word;
+                word |= uint64_t(1) << (index % WORD_BITS);
+                if (!was_empty)
+                    return;
+                index /= WORD_BITS;
+            }
+        }
+
+        // bits must be in the same word
+        void ClearBits(size_t index, size_t count) {
+            assert(index % WORD_BITS + count <= WORD_BITS);
+
+            auto mask = (count == WORD_BITS ? ~uint64_t(0) : (uint64_t(1) << count) - 1) << (index % WORD_BITS);
+            for (auto& level : m_levels) {
+                auto& word = level[index / WORD_BITS];
+                word &= ~mask;
+                if (word)
+                    return;
+                index /= WORD_BITS;
+                mask = uint64_t(1) << (index % WORD_BITS);
+            }
+        }
+
+        // the top level always consists of a single word
+        void Reserve(size_t bits_count) {
+            size_t words_count = (bits_count + WORD_BITS - 1) / WORD_BITS;
+            for (size_t level = 0; ; level++) {
+                if (m_levels.size() == level) {
+                    // the new top level marks the only word of the previous top level
+                    m_levels.emplace_back(1, level && m_levels[level - 1][0] ? uint64_t(1) : uint64_t(0));
+                }
+                if (m_levels[level].size() < words_count)
+                    m_levels[level].resize(words_count);
+                if (m_levels[level].size() == 1)
+                    return;
+
+                words_count = (m_levels[level].size() + WORD_BITS - 1) / WORD_BITS;
+            }
+        }
+
+        ID_T m_max_id = 0;
+        size_t m_available_count = 0;
+        std::vector<std::vector<uint64_t>> m_levels{ std::vector<uint64_t>(1) };
+    };
+
+    using BitmapIdPool = BitmapIdPoolT<CU_ID_TYPE>;
+
+    // Thread-safe lock-free pool of identifiers in range [0, capacity).
+    // Free identifiers form an intrusive stack (Treiber stack) over the fixed array of links,
+    // the head of the stack is tagged by the counter of modifications to avoid ABA problem.
+    // Unlike IdPoolT, the most recently freed identifier is reused first and the pool never shrinks.
+    // The head keeps the identifier in 32 bits, so for 64-bit ID_T the capacity is limited to 32 bits.
+    template<std::unsigned_integral ID_T>
+    class ConcurrentIdPoolT {
+    public:
+        explicit ConcurrentIdPoolT(ID_T capacity) :
+            m_capacity(capacity),
+            m_links(std::make_unique<std::atomic<ID_T>[]>(capacity)) {
+            assert(capacity < LOCKED_LINK && uint64_t(capacity) < HEAD_END_LINK);
+            for (ID_T id = 0; id < capacity; id++) {
+                m_links[id].store(LOCKED_LINK, std::memory_order_relaxed);
+            }
+        }
+
+        ConcurrentIdPoolT(const ConcurrentIdPoolT&)            = delete;
+        ConcurrentIdPoolT(ConcurrentIdPoolT&&)                 = delete;
+        ConcurrentIdPoolT& operator=(const ConcurrentIdPoolT&) = delete;
+        ConcurrentIdPoolT& operator=(ConcurrentIdPoolT&&)      = delete;
+
+        // returns INVALID_ID if all identifiers are locked
+        ID_T LockId() {
+            auto head = m_free_head.load(std::memory_order_acquire);
+            while (END_LINK != GetHeadId(head)) {
+                const auto id = GetHeadId(head);
+                // the link can be stale if the identifier was popped concurrently, then the tag is changed
+                const auto next = m_links[id].load(std::memory_order_relaxed);
+                if (m_free_head.compare_exchange_weak(head, MakeHead(GetHeadTag(head) + 1, next),
+                                                      std::memory_order_acquire, std::memory_order_acquire)) {
+                    m_links[id].store(LOCKED_LINK, std::memory_order_relaxed);
+                    return id;
+                }
+            }
+
+            // the free list is empty, a new identifier is taken
+            auto id = m_max_id.load(std::memory_order_relaxed);
+            do {
+                if (id >= m_capacity)
+                    return INVALID_ID_T;
+            } while (!m_max_id.compare_exchange_weak(id, ID_T(id + 1), std::memory_order_relaxed));
+            return id;
+        }
+
+        // the result is reliable only if the identifier isn't modified concurrently
+        bool CheckId(ID_T id) const {
+            return id < m_max_id.load(std::memory_order_relaxed) &&
+                   LOCKED_LINK == m_links[id].load(std::memory_order_relaxed);
+        }
+
+        void FreeId(ID_T id) {
+            assert(CheckId(id));
+
+            auto head = m_free_head.load(std::memory_order_relaxed);
+            do {
+                m_links[id].store(GetHeadId(head), std::memory_order_relaxed);
+            } while (!m_free_head.compare_exchange_weak(head, MakeHead(GetHeadTag(head) + 1, id),
+                                                        std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        ID_T GetCapacity() const { return m_capacity; }
+
+    private:
+        static constexpr ID_T INVALID_ID_T = std::numeric_limits<ID_T>::max();
+        static constexpr ID_T END_LINK     = INVALID_ID_T;
+        static constexpr ID_T LOCKED_LINK  = INVALID_ID_T - 1;
+
+        // tag in the high half, identifier in the low half, END_LINK is stored as HEAD_END_LINK
+        static constexpr uint64_t HEAD_END_LINK = 0xffffffffu;
+
+        static constexpr uint64_t MakeHead(uint64_t tag, ID_T id) {
+            return (tag << 32) | (END_LINK == id ? HEAD_END_LINK : uint64_t(id));
+        }
+        static constexpr ID_T GetHeadId(uint64_t head) {
+            const uint64_t id = head & HEAD_END_LINK;
+            return HEAD_END_LINK == id ? END_LINK : ID_T(id);
+        }
+        static constexpr uint64_t GetHeadTag(uint64_t head) { return head >> 32; }
+
+        const ID_T m_capacity;
+        std::unique_ptr<std::atomic<ID_T>[]> m_links;
+        std::atomic<uint64_t> m_free_head{ MakeHead(0, END_LINK) };
+        std::atomic<ID_T> m_max_id{ 0 };
+    };
+
+    using ConcurrentIdPool = ConcurrentIdPoolT<CU_ID_TYPE>;
+
+    // Handle of an object stored in a slot map: the index of the slot in the lower half of the packed value,
+    // the generation of the slot in the upper half. The generation is incremented when the object is erased,
+    // so the stale handle of the erased object doesn't refer to the new object stored in the same slot.
+    template<std::unsigned_integral PACKED_T>
+        requires (sizeof(PACKED_T) >= sizeof(uint16_t))
+    class GenerationalHandleT {
+    public:
+        using Packed = PACKED_T;
+        using Index = std::conditional_t<sizeof(Packed) == sizeof(uint64_t), uint32_t,
+                      std::conditional_t<sizeof(Packed) == sizeof(uint32_t), uint16_t, uint8_t>>;
+
+        static constexpr size_t INDEX_BITS = sizeof(Index) * 8;
+        // all bits set, the maximum index isn't used by slot maps
+        static constexpr Packed INVALID = std::numeric_limits<Packed>::max();
+        static constexpr Index MAX_INDEX = std::numeric_limits<Index>::max() - 1;
+
+        constexpr GenerationalHandleT() = default;
+        constexpr GenerationalHandleT(Index index, Index generation) :
+            m_packed(Packed(Packed(generation) << INDEX_BITS) | Packed(index)) {}
+
+        static constexpr GenerationalHandleT FromPacked(Packed packed) {
+            GenerationalHandleT handle;
+            handle.m_packed = packed;
+            return handle;
+        }
+
+        constexpr Packed GetPacked() const { return m_packed; }
+        constexpr Index GetIndex() const { return Index(m_packed); }
+        constexpr Index GetGeneration() const { return Index(m_packed >> INDEX_BITS); }
+        constexpr bool IsValid() const { return INVALID != m_packed; }
+
+        constexpr bool operator==(const GenerationalHandleT&) const = default;
+
+    private:
+        Packed m_packed = INVALID;
+    };
+
+    using GenerationalId  = GenerationalHandleT<CU_ID_TYPE>;
+    using GenerationalUid = GenerationalHandleT<CU_UID_TYPE>;
+
+    // Container of objects addressed by generational handles.
+    // Objects are stored densely (erasing moves the last object to the place of the erased one),
+    // so the iteration over live objects is the iteration over the array. The lookup by handle is O(1)
+    // and returns nullptr for handles of erased objects.
+    // The slot is retired when its generation wraps around, so the stale handles are never reused.
+    template<typename T, typename HANDLE_T = GenerationalId>
+    class SlotMap {
+    public:
+        using Handle = HANDLE_T;
+        using Index = typename Handle::Index;
+
+        // if the constructor of T throws, the map is left unchanged
+        template<typename... Args>
+        Handle Emplace(Args&&... args) {
+            Index slot_index = m_free_head;
+            const bool is_new_slot = INVALID_INDEX == slot_index;
+            if (is_new_slot) {
+                if (m_slots.size() > Handle::MAX_INDEX)
+                    throw std::length_error("Slot map capacity is exceeded");
+                slot_index = Index(m_slots.size());
+            }
+
+            // the arrays grow before the object is constructed and are rolled back if anything throws,
+            // the slot is taken from the free list only after that
+            m_dense_slots.push_back(slot_index);
+            try {
+                if (is_new_slot)
+                    m_slots.emplace_back();
+                m_values.emplace_back(std::forward<Args>(args)...);
+            }
+            catch (...) {
+                if (is_new_slot && m_slots.size() > slot_index)
+                    m_slots.pop_back();
+                m_dense_slots.pop_back();
+                throw;
+            }
+            if (!is_new_slot)
+                m_free_head = m_slots[slot_index].m_dense_index;
+
+            auto& slot = m_slots[slot_index];
+            slot.m_dense_index = Index(m_values.size() - 1);
+            return Handle(slot_index, slot.m_generation);
+        }
+
+        Handle Insert(const T& value) { return Emplace(value); }
+        Handle Insert(T&& value) { return Emplace(std::move(value)); }
+
+        bool Contains(Handle handle) const {
+            if (handle.GetIndex() >= m_slots.size())
+                return false;
+
+            // the slot is live if its object refers back to it
+            const auto& slot = m_slots[handle.GetIndex()];
+            return slot.m_generation == handle.GetGeneration() &&
+                   slot.m_dense_index < m_dense_slots.size() &&
+                   m_dense_slots[slot.m_dense_index] == handle.GetIndex();
+        }
+
+        T* Find(Handle handle) {
+            return Contains(handle) ? &m_values[m_slots[handle.GetIndex()].m_dense_index] : nullptr;
+        }
+
+        const T* Find(Handle handle) const {
+            return Contains(handle) ? &m_values[m_slots[handle.GetIndex()].m_dense_index] : nullptr;
+        }
+
+        // returns false for handles of erased objects
+        bool Erase(Handle handle) {
+            if (!Contains(handle))
+                return false;
+
+            auto& slot = m_slots[handle.GetIndex()];
+            const auto dense_index = slot.m_dense_index;
+            if (dense_index + 1u != m_values.size()) {
+                m_values[dense_index] = std::move(m_values.back());
+                m_dense_slots[dense_index] = m_dense_slots.back();
+                m_slots[m_dense_slots[dense_index]].m_dense_index = dense_index;
+            }
+            m_values.pop_back();
+            m_dense_slots.pop_back();
+
+            // free slots form a list linked by m_dense_index
+            slot.m_dense_index = INVALID_INDEX;
+            if (++slot.m_generation) {
+                slot.m_dense_index = m_free_head;
+                m_free_head = handle.GetIndex();
+            }
+            return true;
+        }
+
+        // the handle of the object with the given position in the dense array
+        Handle GetHandle(size_t dense_index) const {
+            const auto slot_index = m_dense_slots[dense_index];
+            return Handle(slot_index, m_slots[slot_index].m_generation);
+        }
+
+        size_t Size() const { return m_values.size(); }
+        bool Empty() const { return m_values.empty(); }
+
+        auto begin() { return m_values.begin(); }
+        auto end() { return m_values.end(); }
+        auto begin() const { return m_values.begin(); }
+        auto end() const { return m_values.end(); }
+
+    private:
+        static constexpr Index INVALID_INDEX = std::numeric_limits<Index>::max();
+
+        struct Slot {
+            // position of the object in m_values, the next free slot for free slots
+            Index m_dense_index = INVALID_INDEX;
+            Index m_generation = 0;
+        };
+
+        std::vector<T> m_values;
+        std::vector<Index> m_dense_slots;
+        std::vector<Slot> m_slots;
+        Index m_free_head = INVALID_INDEX;
+    };
+
     namespace PrivateImplementation {
         struct UidGenSingletonTemplate {
             UidGenSingletonTemplate(const UidGenSingletonTemplate&) = delete;
@@ -105,75 +481,204 @@ namespace CU {
         using UID = T;
 
         static UID Get() {
-            static UidGeneratorT gen;
+            return Reserve(1).first;
+        }
 
-            std::scoped_lock lock(gen.m_counter_mutex);
-            if (gen.m_counter == std::numeric_limits<UID>::max())
-                throw std::runtime_error("Limit of unique game session identifiers has been reached");
-            return gen.m_counter++;
+        // UIDs are reserved by blocks of block_size for the current thread, so most calls don't touch
+        // the shared counter. UIDs are unique, but aren't ordered between threads.
+        template<UID block_size>
+            requires (block_size > 0)
+        static UID GetFromThreadBlock() {
+            struct ThreadBlock {
+                UID m_next = 0;
+                UID m_end  = 0;
+            };
+            thread_local ThreadBlock block;
+
+            if (block.m_next == block.m_end)
+                std::tie(block.m_next, block.m_end) = Reserve(block_size);
+            return block.m_next++;
         }
 
     private:
         UidGeneratorT() :
             UidGenSingletonTemplate() {}
 
-        std::mutex m_counter_mutex;
-        UID m_counter = 0;
+        // Returns the range [first, end) of at most count UIDs.
+        // The maximum value of UID is never returned, so the exhausted counter stays at the maximum.
+        static std::pair<UID, UID> Reserve(UID count) {
+            static UidGeneratorT gen;
+
+            auto counter = gen.m_counter.load(std::memory_order_relaxed);
+            UID end;
+            do {
+                if (counter == std::numeric_limits<UID>::max())
+                    throw std::runtime_error("Limit of unique game session identifiers has been reached");
+                end = std::numeric_limits<UID>::max() - counter > count ? UID(counter + count) : std::numeric_limits<UID>::max();
+            } while (!gen.m_counter.compare_exchange_weak(counter, end, std::memory_order_relaxed));
+            return { counter, end };
+        }
+
+        std::atomic<UID> m_counter = 0;
     };
 
     using UidGenerator = UidGeneratorT<CU_UID_TYPE>;
     using uid_t = UidGenerator::UID;
     constexpr inline auto UID_STR_WIDTH = sizeof(uid_t) * 2;
 
+    // Generator of 64-bit UIDs: milliseconds since EPOCH | worker identifier | sequence number.
+    // UIDs of different workers (processes, hosts) never collide, UIDs of a worker grow with time.
+    // The last timestamp and sequence are packed into a single atomic word, so the generator is lock-free.
+    // If the clock goes backward or the sequence of the millisecond is exhausted, the sequence continues
+    // after the last generated UID (borrowing the next milliseconds), so UIDs are never repeated.
+    class SnowflakeUidGenerator {
+    public:
+        static constexpr uint64_t TIMESTAMP_BITS = 41;
+        static constexpr uint64_t WORKER_BITS    = 10;
+        static constexpr uint64_t SEQUENCE_BITS  = 12;
+        static constexpr uint64_t MAX_WORKER_ID = (uint64_t(1) << WORKER_BITS) - 1;
+        // 2024-01-01T00:00:00Z, timestamps are enough for ~69 years
+        static constexpr std::chrono::milliseconds EPOCH{ 1704067200000 };
+
+        // must be called before the first UID is generated, the worker identifier is 0 by default
+        static void SetWorkerId(uint64_t worker_id) {
+            if (worker_id > MAX_WORKER_ID)
+                throw std::invalid_argument("Worker identifier of Snowflake UID is out of range");
+            m_worker_id.store(worker_id, std::memory_order_relaxed);
+        }
+
+        static uint64_t Get() {
+            // milliseconds are compared before the unsigned subtraction, so there is no signed arithmetic
+            const auto since_epoch = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch());
+            const auto now = since_epoch > EPOCH ? uint64_t(since_epoch.count()) - uint64_t(EPOCH.count()) : uint64_t(0);
+
+            // timestamp | sequence, without the worker
+            auto last = m_last_state.load(std::memory_order_relaxed);
+            uint64_t state;
+            do {
+                state = std::max(now << SEQUENCE_BITS, last + 1);
+                if (state >> (SEQUENCE_BITS + TIMESTAMP_BITS))
+                    throw std::runtime_error("Limit of Snowflake UID timestamps has been reached");
+            } while (!m_last_state.compare_exchange_weak(last, state, std::memory_order_relaxed));
+
+            const auto sequence = state & ((uint64_t(1) << SEQUENCE_BITS) - 1);
+            const auto timestamp = state >> SEQUENCE_BITS;
+            return (timestamp << (WORKER_BITS + SEQUENCE_BITS)) |
+                   (m_worker_id.load(std::memory_order_relaxed) << SEQUENCE_BITS) |
+                   sequence;
+        }
+
+        static std::chrono::system_clock::time_point GetTime(uint64_t uid) {
+            return std::chrono::system_clock::time_point(
+                EPOCH + std::chrono::milliseconds(uid >> (WORKER_BITS + SEQUENCE_BITS)));
+        }
+
+        static uint64_t GetWorkerId(uint64_t uid) {
+            return (uid >> SEQUENCE_BITS) & MAX_WORKER_ID;
+        }
+
+        static uint64_t GetSequence(uint64_t uid) {
+            return uid & ((uint64_t(1) << SEQUENCE_BITS) - 1);
+        }
+
+    private:
+        inline static std::atomic<uint64_t> m_last_state = 0;
+        inline static std::atomic<uint64_t> m_worker_id = 0;
+    };
+
     static inline uid_t get_uid() {
+#if defined(CU_UID_SNOWFLAKE)
+        static_assert(sizeof(uid_t) == sizeof(uint64_t), "Snowflake UIDs require 64-bit CU_UID_TYPE");
+        return SnowflakeUidGenerator::Get();
+#elif defined(CU_UID_THREAD_BLOCK_SIZE)
+        return UidGenerator::GetFromThreadBlock<CU_UID_THREAD_BLOCK_SIZE>();
+#else
         return UidGenerator::Get();
+#endif // CU_UID_SNOWFLAKE
+    }
+
+    // " {" + UID_STR_WIDTH hex digits + "}"
+    constexpr inline auto UID_SUFFIX_SIZE = UID_STR_WIDTH + 3;
+
+    // Writes the suffix of the unique name (UID_SUFFIX_SIZE chars) to the buffer, returns the end of the suffix.
+    static inline char* write_uid_suffix(char* first, uid_t uid) {
+        *first++ = ' ';
+        *first++ = '{';
+
+        // std::to_chars doesn't pad, so the digits are moved to the end of the field
+        char* const digits_end = first + UID_STR_WIDTH;
+        [[maybe_unused]] auto [ptr, ec] = std::to_chars(first, digits_end, uid, 16);
+        assert(ec == std::errc{});
+        const auto digits_count = size_t(ptr - first);
+        std::copy_backward(first, ptr, digits_end);
+        std::fill_n(first, UID_STR_WIDTH - digits_count, '0');
+
+        *digits_end = '}';
+        return digits_end + 1;
     }
 
-    static inline std::string concat_with_uid(const std::string& name, uid_t uid) {
-        std::stringstream ss;
-        ss << name << " {"
-            << std::hex
-            << std::setw(UID_STR_WIDTH)
-            << std::setfill('0')
-            << uid
-            << "}";
-        return ss.str();
+    // Writes the unique name to the caller-provided buffer without allocations.
+    // Returns the view of the written name, the empty view if the buffer is too small.
+    static inline std::string_view concat_with_uid(std::string_view name, uid_t uid, std::span<char> buffer) {
+        if (buffer.size() < name.size() + UID_SUFFIX_SIZE)
+            return {};
+
+        std::copy(name.begin(), name.end(), buffer.data());
+        write_uid_suffix(buffer.data() + name.size(), uid);
+        return { buffer.data(), name.size() + UID_SUFFIX_SIZE };
     }
 
-    static inline std::string get_unique_name(const std::string& name) {
+    static inline std::string concat_with_uid(std::string_view name, uid_t uid) {
+        std::string result(name.size() + UID_SUFFIX_SIZE, '\0');
+        concat_with_uid(name, uid, result);
+        return result;
+    }
+
+    static inline std::string get_unique_name(std::string_view name) {
         return concat_with_uid(name, get_uid());
     }
 
-    static inline bool is_contains_uid(const std::string& name) {
-        if (name.length() < UID_STR_WIDTH + 3) /* space + { + UID_STR_WIDTH + } */
+    static inline bool is_contains_uid(std::string_view name) {
+        if (name.length() < UID_SUFFIX_SIZE)
             return false;
 
         auto bracket_index = name.length() - 2 - UID_STR_WIDTH;
-        if (!(name[bracket_index - 1] != ' ') || !(name[bracket_index] != '{') || !name.ends_with('}'))
+        if (name[bracket_index - 1] != ' ' || name[bracket_index] != '{' || !name.ends_with('}'))
             return false;
 
         for (auto i = bracket_index + 1; i < name.length() - 1; i++) {
-            if (!std::isxdigit(name[i]))
+            if (!std::isxdigit(static_cast<unsigned char>(name[i])))
                 return false;
         }
 
         return true;
     }
 
+    // returns the view of the name part of unique_name
+    static inline std::string_view uid_extract_name_view(std::string_view unique_name) {
+        assert(is_contains_uid(unique_name));
+
+        return unique_name.substr(0, unique_name.length() - UID_SUFFIX_SIZE);
+    }
+
     static inline std::string uid_extract_name(std::string unique_name) {
         assert(is_contains_uid(unique_name));
 
-        const auto uid_index = unique_name.length() - 1 - UID_STR_WIDTH;
-        return unique_name.erase(uid_index);
+        unique_name.resize(unique_name.length() - UID_SUFFIX_SIZE);
+        return unique_name;
     }
 
-    static inline uid_t extract_uid(std::string unique_name) {
+    static inline uid_t extract_uid(std::string_view unique_name) {
         assert(is_contains_uid(unique_name));
 
+        // the digits are validated by is_contains_uid, so they are parsed without std::from_chars checks
         uid_t result{};
-        const auto uid_start = unique_name.data() + unique_name.length() - 1 - UID_STR_WIDTH;
-        [[maybe_unused]] auto [ptr, ec] = std::from_chars(uid_start, uid_start + UID_STR_WIDTH, result, 16);
-        assert(ec == std::errc{});
+        for (const char digit : unique_name.substr(unique_name.length() - 1 - UID_STR_WIDTH, UID_STR_WIDTH)) {
+            const auto symbol = static_cast<unsigned char>(digit);
+            const auto value = symbol <= '9' ? unsigned(symbol - '0') : unsigned((symbol | 0x20u) - 'a' + 10);
+            result = uid_t(result << 4) | uid_t(value);
+        }
         return result;
     }
 }
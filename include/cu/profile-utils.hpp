@@ -10,12 +10,34 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <chrono>
 #include <unordered_map>
+#include <deque>
+#include <map>
+#include <array>
+#include <memory>
+#include <atomic>
+#include <bit>
 #include <cassert>
 #include <mutex>
+#include <vector>
 #include <ranges>
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <condition_variable>
+
+#if defined(CU_ARCH_X86_64)
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  else
+#    include <x86intrin.h>
+#  endif
+#endif // CU_ARCH_X86_64
 
 // Macro descriptions:
 //
@@ -26,6 +48,12 @@
 // their measurement results in memory, but no automatic logging will occur.
 // The measurement results can still be retrieved by calling CU_PROFILE_GET_RESULTS.
 //
+// USE_CU_PROFILE_CONFIG(CONFIG)
+// The same as USE_CU_PROFILE, but the profiler is configured by CONFIG (CU::ProfilerConfiguration).
+// Only the first call of USE_CU_PROFILE or USE_CU_PROFILE_CONFIG takes effect.
+// The configuration selects the sinks of the reports (stdout, file; text, CSV or JSON) and may start
+// a background thread writing reports of the last interval periodically.
+//
 // CU_PROFILE_CHECKBLOCK(NAME, KEY) (NAME and KEY are optional)
 // Macro that creates a timer measuring the duration from its creation to the end of the current code block
 // (i.e., the end of the current compound statement).
@@ -37,6 +65,11 @@
 // This allows a single named timer to save its measurements under different keys,
 // depending on the value of the variable in KEY. KEY must be convertible to std::string.
 //
+// CU_PROFILE_CHECKBLOCK_SAMPLED(RATE, NAME, KEY) (NAME and KEY are optional)
+// The same as CU_PROFILE_CHECKBLOCK, but only 1 in RATE activations of the site in the thread is timed.
+// Activations counts stay exact, durations are collected only for timed activations and the total duration
+// is extrapolated (see TimerResult::GetEstimatedTotalNS). Intended for very hot blocks.
+//
 // CU_STOP_CHECKBLOCK(NAME)
 // Macro that stops the timer with the specified NAME.
 //
@@ -44,29 +77,295 @@
 // Macro that returns all available measurement results.
 // If FILTER is provided, only the results matching the keys in FILTER will be returned.
 // FILTER must be a range-iterating container and contain values convertible to std::string
+//
+// CU_PROFILE_WRITE_CALL_TREE(STREAM)
+// Macro that writes the call tree of nested timers to STREAM (std::ostream) in the collapsed stacks format
+// ("parent;child;grandchild <exclusive duration in ns>" per line) accepted by flamegraph tools.
+// The call tree is collected only if it's enabled in CU::ProfilerConfiguration.
+//
+// CU_PROFILE_WRITE_TRACE(STREAM)
+// Macro that writes the latest activations of all timers to STREAM (std::ostream) in the Chrome Trace Event format
+// (JSON, can be opened by chrome://tracing or Perfetto UI).
+// The activations are recorded only if the trace buffer is enabled in CU::ProfilerConfiguration.
 
 #define USE_CU_PROFILE               CU::ProfilerAggregator::Setup()
+#define USE_CU_PROFILE_CONFIG(...)   CU::ProfilerAggregator::Setup(__VA_ARGS__)
 #define CU_PROFILE_CHECKBLOCK(...)   CU_CHOOSE_MACRO_BY_ARGS_COUNT(CU_PROFILE_CHECKBLOCK, __VA_ARGS__)
+#define CU_PROFILE_CHECKBLOCK_SAMPLED(RATE, ...) \
+    CU_GENERATE_MACRO_IMPL_NAME(CU_PROFILE_CHECKBLOCK_SAMPLED, CU_GET_ARGS_COUNT(__VA_ARGS__))(RATE __VA_OPT__(,) __VA_ARGS__)
 #define CU_STOP_CHECKBLOCK(NAME)     NAME ##_timer.Stop()
 #define CU_PROFILE_GET_RESULTS(...)  CU::ProfilerAggregator::GetCurrentResults(__VA_ARGS__)
+#define CU_PROFILE_WRITE_CALL_TREE(STREAM) CU::ProfilerAggregator::WriteCollapsedStacks(STREAM)
+#define CU_PROFILE_WRITE_TRACE(STREAM)     CU::ProfilerAggregator::WriteTrace(STREAM)
 
 // Implementation
+// Every call site registers its description once (static TimerSite), timers refer to it only by identifier.
 #define CU_TIMER_NAME CU_EXPAND_CONCAT(timer, __LINE__)
-#define CU_PROFILE_CHECKBLOCK_0() CU::CheckBlockTimer CU_TIMER_NAME { "", \
-                                              std::string(__FILE__).erase(0, CU_PREFIX_LENGTH + 1), __LINE__, __FUNCTION__}
-#define CU_PROFILE_CHECKBLOCK_1(NAME) CU::CheckBlockTimer NAME ##_timer{ std::string(#NAME) + ": ", \
-                                              std::string(__FILE__).erase(0, CU_PREFIX_LENGTH + 1), __LINE__, __FUNCTION__}
-#define CU_PROFILE_CHECKBLOCK_2(NAME, KEY) CU::CheckBlockTimer NAME ##_timer{ std::string(KEY) + ": ", \
-                                              std::string(__FILE__).erase(0, CU_PREFIX_LENGTH + 1), __LINE__, __FUNCTION__}
+#define CU_TIMER_SITE_NAME CU_EXPAND_CONCAT(timer_site, __LINE__)
+#define CU_TIMER_SITE_IMPL(PREFIX, IS_KEYED) static const CU::TimerSite CU_TIMER_SITE_NAME{ PREFIX, \
+                                              __FILE__, CU_PREFIX_LENGTH + 1, __LINE__, __FUNCTION__, IS_KEYED }
+#define CU_TIMER_SITE(PREFIX) CU_TIMER_SITE_IMPL(PREFIX, false)
+// sites of CU_PROFILE_CHECKBLOCK(NAME, KEY) don't have their own timer, only the timers of the keys
+#define CU_KEYED_TIMER_SITE() CU_TIMER_SITE_IMPL("", true)
+#define CU_PROFILE_CHECKBLOCK_0() CU_TIMER_SITE(""); \
+                                  CU::CheckBlockTimer CU_TIMER_NAME{ CU_TIMER_SITE_NAME.GetId() }
+#define CU_PROFILE_CHECKBLOCK_1(NAME) CU_TIMER_SITE(#NAME ": "); \
+                                      CU::CheckBlockTimer NAME ##_timer{ CU_TIMER_SITE_NAME.GetId() }
+#define CU_PROFILE_CHECKBLOCK_2(NAME, KEY) CU_KEYED_TIMER_SITE(); \
+                                           CU::CheckBlockTimer NAME ##_timer{ CU_TIMER_SITE_NAME.GetKeyId(KEY) }
+
+// Every thread counts activations of the sampled site by its own trivial thread_local counter.
+#define CU_SAMPLING_COUNTER_NAME CU_EXPAND_CONCAT(timer_sampling_counter, __LINE__)
+#define CU_SAMPLING_COUNTER static thread_local uint64_t CU_SAMPLING_COUNTER_NAME = 0
+#define CU_PROFILE_CHECKBLOCK_SAMPLED_0(RATE) CU_TIMER_SITE(""); CU_SAMPLING_COUNTER; \
+    CU::CheckBlockTimer CU_TIMER_NAME{ CU_TIMER_SITE_NAME.GetId(), \
+                                       CU::CheckBlockTimer::IsSampled(CU_SAMPLING_COUNTER_NAME, RATE) }
+#define CU_PROFILE_CHECKBLOCK_SAMPLED_1(RATE, NAME) CU_TIMER_SITE(#NAME ": "); CU_SAMPLING_COUNTER; \
+    CU::CheckBlockTimer NAME ##_timer{ CU_TIMER_SITE_NAME.GetId(), \
+                                       CU::CheckBlockTimer::IsSampled(CU_SAMPLING_COUNTER_NAME, RATE) }
+#define CU_PROFILE_CHECKBLOCK_SAMPLED_2(RATE, NAME, KEY) CU_KEYED_TIMER_SITE(); CU_SAMPLING_COUNTER; \
+    CU::CheckBlockTimer NAME ##_timer{ CU_TIMER_SITE_NAME.GetKeyId(KEY), \
+                                       CU::CheckBlockTimer::IsSampled(CU_SAMPLING_COUNTER_NAME, RATE) }
 
 // implementation
 namespace CU {
+    using TimerId = uint32_t;
+
+    class ProfilerSink;
+
+    enum class ProfilerClockSource {
+        STEADY_CLOCK, // std::chrono::steady_clock
+        TSC,          // Time Stamp Counter, used only if it's invariant, otherwise STEADY_CLOCK is used
+        AUTO          // TSC if it's invariant, otherwise STEADY_CLOCK
+    };
+
+    struct ProfilerConfiguration {
+        // collect latency histograms of timers, required for percentiles
+        bool m_collect_histograms = false;
+        // the clock used by timers, TSC is calibrated once during the profiler setup
+        ProfilerClockSource m_clock_source = ProfilerClockSource::STEADY_CLOCK;
+        // collect the call tree of nested timers
+        bool m_collect_call_tree = false;
+        // capacity of the per-thread ring buffer of timers activations (trace events), 0 disables the trace.
+        // Only the latest activations are kept when the buffer is full.
+        size_t m_trace_buffer_capacity = 0;
+        // if not empty, the trace is written to this file when the profiler is destroyed
+        std::filesystem::path m_trace_file = {};
+        // destinations of the reports, the text report to std::cout is used if empty
+        std::vector<std::shared_ptr<ProfilerSink>> m_sinks = {};
+        // collect hardware counters (cycles, instructions, cache misses, branch misses) of every activation,
+        // available only on Linux with accessible perf events, timers collect only durations otherwise
+        // (HardwareCountersReader::IsAvailable reports it)
+        bool m_collect_hardware_counters = false;
+        // period of the reports of timers activations finished during the last interval, 0 disables them.
+        // The reports are written by the background thread, the total report is written when the profiler is destroyed.
+        std::chrono::milliseconds m_report_interval = std::chrono::milliseconds(0);
+    };
+
+    // Source of the timers timestamps.
+    // Timestamps are measured in ticks of the selected clock, durations are converted by ToNanoseconds.
+    // The clock must be selected before the start of timers, timers running during the selection are invalid.
+    class ProfilerClock {
+    public:
+        // Returns false if TSC is required explicitly, but it isn't invariant, the steady clock is used then.
+        static bool Setup(ProfilerClockSource source);
+
+        static bool IsTscUsed() {
+            return ClockMode::STEADY_CLOCK != m_mode.load(std::memory_order_acquire);
+        }
+
+        static int64_t Now() {
+#if defined(CU_ARCH_X86_64)
+            switch (m_mode.load(std::memory_order_acquire)) {
+            case ClockMode::RDTSCP: {
+                unsigned int aux;
+                return int64_t(__rdtscp(&aux));
+            }
+            case ClockMode::RDTSC:
+                return int64_t(__rdtsc());
+            case ClockMode::STEADY_CLOCK:
+                break;
+            }
+#endif // CU_ARCH_X86_64
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        static int64_t ToNanoseconds(int64_t ticks) {
+            if (!IsTscUsed())
+                return ticks;
+
+            // the ratio is published before the mode
+            return int64_t(double(ticks) * m_ns_per_tick.load(std::memory_order_relaxed));
+        }
+
+    private:
+        enum class ClockMode {
+            STEADY_CLOCK,
+            RDTSC,
+            RDTSCP
+        };
+
+        static std::atomic<ClockMode> m_mode;
+        static std::atomic<double> m_ns_per_tick;
+    };
+
+    // Log-linear histogram of durations (HDR-like).
+    // Durations less than SUB_BUCKETS_COUNT are stored exactly, every next power of two range
+    // is divided into SUB_BUCKETS_COUNT equal buckets, so the relative error doesn't exceed 1 / SUB_BUCKETS_COUNT.
+    // The size of the histogram is fixed and covers the whole int64_t range.
+    class LatencyHistogram {
+    public:
+        static constexpr int SUB_BUCKETS_BITS  = 4;
+        static constexpr int SUB_BUCKETS_COUNT = 1 << SUB_BUCKETS_BITS;
+        static constexpr int BUCKETS_COUNT     = (64 - SUB_BUCKETS_BITS) * SUB_BUCKETS_COUNT;
+
+        void StoreDuration(int64_t duration_ns) {
+            m_buckets[GetBucketIndex(duration_ns)]++;
+            m_total_count++;
+        }
+
+        void Merge(const LatencyHistogram& other) {
+            for (size_t i = 0; i < m_buckets.size(); i++) {
+                m_buckets[i] += other.m_buckets[i];
+            }
+            m_total_count += other.m_total_count;
+        }
+
+        void Reset() {
+            m_buckets.fill(0);
+            m_total_count = 0;
+        }
+
+        bool IsEmpty() const {
+            return !m_total_count;
+        }
+
+        // percentile in range [0, 100]
+        // returns the highest duration equivalent to the found bucket, -1 for empty histogram
+        int64_t GetPercentileNS(double percentile) const {
+            if (!m_total_count)
+                return -1;
+
+            const auto rank = std::max(uint64_t(1), uint64_t(std::ceil(percentile / 100.0 * double(m_total_count))));
+            uint64_t counted = 0;
+            for (size_t i = 0; i < m_buckets.size(); i++) {
+                counted += m_buckets[i];
+                if (counted >= rank)
+                    return GetBucketUpperBound(i);
+            }
+            return std::numeric_limits<int64_t>::max();
+        }
+
+    private:
+        static size_t GetBucketIndex(int64_t duration_ns) {
+            assert(duration_ns >= 0);
+
+            const auto value = uint64_t(duration_ns);
+            if (value < SUB_BUCKETS_COUNT)
+                return size_t(value);
+
+            const int shift = std::bit_width(value) - 1 - SUB_BUCKETS_BITS;
+            return size_t(shift + 1) * SUB_BUCKETS_COUNT + size_t((value >> shift) & (SUB_BUCKETS_COUNT - 1));
+        }
+
+        static int64_t GetBucketUpperBound(size_t index) {
+            if (index < SUB_BUCKETS_COUNT)
+                return int64_t(index);
+
+            const auto shift = index / SUB_BUCKETS_COUNT - 1;
+            const auto mantissa = uint64_t(SUB_BUCKETS_COUNT + index % SUB_BUCKETS_COUNT);
+            return int64_t(((mantissa + 1) << shift) - 1);
+        }
+
+        std::array<uint64_t, BUCKETS_COUNT> m_buckets{};
+        uint64_t m_total_count = 0;
+    };
+
+    struct HardwareCounters {
+        int64_t m_cycles        = 0;
+        int64_t m_instructions  = 0;
+        int64_t m_cache_misses  = 0;
+        int64_t m_branch_misses = 0;
+
+        HardwareCounters& operator+=(const HardwareCounters& other) {
+            m_cycles        += other.m_cycles;
+            m_instructions  += other.m_instructions;
+            m_cache_misses  += other.m_cache_misses;
+            m_branch_misses += other.m_branch_misses;
+            return *this;
+        }
+
+        HardwareCounters operator-(const HardwareCounters& other) const {
+            return {
+                m_cycles        - other.m_cycles,
+                m_instructions  - other.m_instructions,
+                m_cache_misses  - other.m_cache_misses,
+                m_branch_misses - other.m_branch_misses };
+        }
+    };
+
+    // Hardware counters of the thread that created the reader (Linux perf events, user space only).
+    // The reader is unavailable if any of the counters can't be opened.
+    class HardwareCountersReader {
+    public:
+        HardwareCountersReader();
+        ~HardwareCountersReader();
+
+        HardwareCountersReader(const HardwareCountersReader&)            = delete;
+        HardwareCountersReader(HardwareCountersReader&&)                 = delete;
+        HardwareCountersReader& operator=(const HardwareCountersReader&) = delete;
+        HardwareCountersReader& operator=(HardwareCountersReader&&)      = delete;
+
+        bool IsAvailable() const { return m_is_available; }
+
+        // returns false if the counters can't be read
+        bool Read(HardwareCounters& counters) const;
+
+    private:
+        static constexpr size_t COUNTERS_COUNT = 4;
+
+        std::array<int, COUNTERS_COUNT> m_descriptors;
+        bool m_is_available = false;
+    };
+
     struct TimerResult {
+        // all activations, including activations skipped by sampling
         int64_t m_activations_count = 0;
+        // activations skipped by sampling, their durations aren't measured
+        int64_t m_untimed_activations_count = 0;
+        // durations of timed activations only
         int64_t m_total_duration_ns = 0;
         int64_t m_min_duration_ns = std::numeric_limits<int64_t>::max();
         int64_t m_max_duration_ns = -1;
 
+        // sum of hardware counters of the activations measured with counters (see ProfilerConfiguration)
+        HardwareCounters m_hardware_counters;
+        int64_t m_hardware_counters_count = 0;
+
+        // exists only if histograms collection is enabled (see ProfilerConfiguration)
+        std::unique_ptr<LatencyHistogram> m_histogram;
+
+        TimerResult() = default;
+        TimerResult(TimerResult&&) = default;
+        TimerResult& operator=(TimerResult&&) = default;
+
+        TimerResult(const TimerResult& other) :
+            m_activations_count(other.m_activations_count),
+            m_untimed_activations_count(other.m_untimed_activations_count),
+            m_total_duration_ns(other.m_total_duration_ns),
+            m_min_duration_ns(other.m_min_duration_ns),
+            m_max_duration_ns(other.m_max_duration_ns),
+            m_hardware_counters(other.m_hardware_counters),
+            m_hardware_counters_count(other.m_hardware_counters_count),
+            m_histogram(other.m_histogram ? std::make_unique<LatencyHistogram>(*other.m_histogram) : nullptr) {}
+
+        TimerResult& operator=(const TimerResult& other) {
+            if (this != &other)
+                *this = TimerResult(other);
+            return *this;
+        }
+
         void StoreDuration(int64_t duration_ns) {
             assert(duration_ns >= 0);
 
@@ -76,25 +375,288 @@ namespace CU {
                 m_min_duration_ns = duration_ns;
             if (m_max_duration_ns < duration_ns)
                 m_max_duration_ns = duration_ns;
+            if (m_histogram)
+                m_histogram->StoreDuration(duration_ns);
+        }
+
+        void StoreUntimedActivations(int64_t activations_count) {
+            m_activations_count += activations_count;
+            m_untimed_activations_count += activations_count;
+        }
+
+        void StoreHardwareCounters(const HardwareCounters& counters) {
+            m_hardware_counters += counters;
+            m_hardware_counters_count++;
         }
 
+        void Merge(const TimerResult& other) {
+            m_activations_count += other.m_activations_count;
+            m_untimed_activations_count += other.m_untimed_activations_count;
+            m_total_duration_ns += other.m_total_duration_ns;
+            if (m_min_duration_ns > other.m_min_duration_ns)
+                m_min_duration_ns = other.m_min_duration_ns;
+            if (m_max_duration_ns < other.m_max_duration_ns)
+                m_max_duration_ns = other.m_max_duration_ns;
+            m_hardware_counters += other.m_hardware_counters;
+            m_hardware_counters_count += other.m_hardware_counters_count;
+
+            if (other.m_histogram) {
+                if (!m_histogram)
+                    m_histogram = std::make_unique<LatencyHistogram>();
+                m_histogram->Merge(*other.m_histogram);
+            }
+        }
+
+        // the histogram remains allocated
+        void Reset() {
+            m_activations_count = 0;
+            m_untimed_activations_count = 0;
+            m_total_duration_ns = 0;
+            m_min_duration_ns = std::numeric_limits<int64_t>::max();
+            m_max_duration_ns = -1;
+            m_hardware_counters = {};
+            m_hardware_counters_count = 0;
+            if (m_histogram)
+                m_histogram->Reset();
+        }
+
+        int64_t GetTimedActivationsCount() const {
+            return m_activations_count - m_untimed_activations_count;
+        }
+
+        // average duration of timed activations
         int64_t GetAvgNS() const {
-            if (!m_activations_count)
+            if (!GetTimedActivationsCount())
                 return 0;
 
-            return m_total_duration_ns / m_activations_count;
+            return m_total_duration_ns / GetTimedActivationsCount();
+        }
+
+        // total duration of all activations, extrapolated from timed activations if the timer is sampled
+        int64_t GetEstimatedTotalNS() const {
+            if (!m_untimed_activations_count)
+                return m_total_duration_ns;
+            if (!GetTimedActivationsCount())
+                return 0;
+
+            return int64_t(double(m_total_duration_ns) / double(GetTimedActivationsCount())
+                           * double(m_activations_count));
+        }
+
+        bool HasHardwareCounters() const {
+            return m_hardware_counters_count > 0;
+        }
+
+        // instructions per cycle
+        double GetIPC() const {
+            if (!m_hardware_counters.m_cycles)
+                return 0.0;
+
+            return double(m_hardware_counters.m_instructions) / double(m_hardware_counters.m_cycles);
+        }
+
+        double GetCacheMissesPerCall() const {
+            if (!m_hardware_counters_count)
+                return 0.0;
+
+            return double(m_hardware_counters.m_cache_misses) / double(m_hardware_counters_count);
+        }
+
+        double GetBranchMissesPerCall() const {
+            if (!m_hardware_counters_count)
+                return 0.0;
+
+            return double(m_hardware_counters.m_branch_misses) / double(m_hardware_counters_count);
+        }
+
+        // histogram is collected and contains timed activations
+        bool HasPercentiles() const {
+            return m_histogram && !m_histogram->IsEmpty();
+        }
+
+        // percentile in range [0, 100], returns -1 if histogram isn't collected
+        int64_t GetPercentileNS(double percentile) const {
+            if (!HasPercentiles())
+                return -1;
+
+            return std::min(m_histogram->GetPercentileNS(percentile), m_max_duration_ns);
         }
     };
     std::ostream& operator<<(std::ostream& os, const TimerResult& tr);
 
+    using TimersResults = std::unordered_map<std::string, TimerResult>;
+
+    enum class ProfilerReportKind {
+        INTERVAL, // activations finished since the previous interval report
+        TOTAL     // all activations since the start of the profiler
+    };
+
+    // Destination of the profiler reports.
+    // Reports are written by one thread at a time: the reporter thread or the destructor of the profiler.
+    class ProfilerSink {
+    public:
+        virtual ~ProfilerSink() = default;
+
+        // interval_duration_ns is the duration covered by the report
+        virtual void Write(ProfilerReportKind kind, int64_t interval_duration_ns, const TimersResults& results) = 0;
+    };
+
+    enum class ProfilerReportFormat {
+        TEXT, // human-readable, the same as operator<< of TimerResult
+        CSV,  // header line and a line per timer for every report
+        JSON  // JSON object per report, one per line
+    };
+
+    class StreamProfilerSink : public ProfilerSink {
+    public:
+        explicit StreamProfilerSink(std::ostream& _os, ProfilerReportFormat _format = ProfilerReportFormat::TEXT) :
+            m_os(_os),
+            m_format(_format) {}
+
+        void Write(ProfilerReportKind kind, int64_t interval_duration_ns, const TimersResults& results) override;
+
+    private:
+        std::ostream& m_os;
+        const ProfilerReportFormat m_format;
+        bool m_is_csv_header_written = false;
+    };
+
+    class FileProfilerSink : public ProfilerSink {
+    public:
+        FileProfilerSink(const std::filesystem::path& _file_name, ProfilerReportFormat _format);
+
+        // reports aren't written if the file can't be opened
+        bool IsOpen() const { return m_file.is_open(); }
+
+        void Write(ProfilerReportKind kind, int64_t interval_duration_ns, const TimersResults& results) override;
+
+    private:
+        std::ofstream m_file;
+        StreamProfilerSink m_stream_sink;
+    };
+
+    // Tree of nested timers activations.
+    // Every node is the path of timers from the root, durations of the node are inclusive,
+    // the exclusive duration is the difference between inclusive duration and durations of the children.
+    // Activations skipped by sampling aren't stored in the tree, so the exclusive duration of a node
+    // includes the durations of its sampled children that weren't timed.
+    class CallTree {
+    public:
+        using NodeIndex = uint32_t;
+        static constexpr NodeIndex ROOT_NODE    = 0;
+        static constexpr NodeIndex INVALID_NODE = std::numeric_limits<NodeIndex>::max();
+
+        struct Node {
+            TimerId   m_timer_id = std::numeric_limits<TimerId>::max();
+            NodeIndex m_parent   = INVALID_NODE;
+            uint32_t  m_depth    = 0;
+
+            TimerResult m_result;
+            int64_t     m_children_duration_ns = 0;
+
+            std::vector<NodeIndex> m_children;
+
+            int64_t GetExclusiveNS() const {
+                const auto duration = m_result.m_total_duration_ns;
+                return duration > m_children_duration_ns ? duration - m_children_duration_ns : 0;
+            }
+        };
+
+        CallTree() : m_nodes(1) {}
+
+        NodeIndex FindChild(NodeIndex parent, TimerId timer_id) const {
+            for (auto child : m_nodes[parent].m_children) {
+                if (m_nodes[child].m_timer_id == timer_id)
+                    return child;
+            }
+            return INVALID_NODE;
+        }
+
+        NodeIndex AddChild(NodeIndex parent, TimerId timer_id) {
+            const auto child = NodeIndex(m_nodes.size());
+
+            Node& node = m_nodes.emplace_back();
+            node.m_timer_id = timer_id;
+            node.m_parent   = parent;
+            node.m_depth    = m_nodes[parent].m_depth + 1;
+
+            m_nodes[parent].m_children.push_back(child);
+            return child;
+        }
+
+        void StoreDuration(NodeIndex node, int64_t duration_ns) {
+            m_nodes[node].m_result.StoreDuration(duration_ns);
+
+            const auto parent = m_nodes[node].m_parent;
+            if (ROOT_NODE != parent)
+                m_nodes[parent].m_children_duration_ns += duration_ns;
+        }
+
+        // merge by the paths of the nodes
+        void MergeTo(CallTree& other) const;
+
+        const Node& GetNode(NodeIndex node) const { return m_nodes[node]; }
+
+    private:
+        std::vector<Node> m_nodes;
+    };
+
+    struct TraceEvent {
+        TimerId m_timer_id    = 0;
+        int64_t m_start_ticks = 0;
+        int64_t m_stop_ticks  = 0;
+    };
+
+    // Ring buffer of the trace events of a single thread.
+    // It's written only by the owner thread without locks and allocations, other threads can copy it at any time:
+    // events overwritten during the copy are dropped.
+    class TraceBuffer {
+    public:
+        TraceBuffer(size_t capacity, uint32_t thread_index) :
+            m_slots(capacity),
+            m_thread_index(thread_index) {}
+
+        void Push(TimerId timer_id, int64_t start_ticks, int64_t stop_ticks) {
+            const auto written = m_written_count.load(std::memory_order_relaxed);
+            auto& slot = m_slots[written % m_slots.size()];
+
+            // odd sequence marks the slot being written
+            slot.m_sequence.store(2 * written + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.m_timer_id.store(timer_id, std::memory_order_relaxed);
+            slot.m_start_ticks.store(start_ticks, std::memory_order_relaxed);
+            slot.m_stop_ticks.store(stop_ticks, std::memory_order_relaxed);
+            slot.m_sequence.store(2 * written + 2, std::memory_order_release);
+
+            m_written_count.store(written + 1, std::memory_order_release);
+        }
+
+        void CopyTo(std::vector<TraceEvent>& events) const;
+
+        uint32_t GetThreadIndex() const { return m_thread_index; }
+
+    private:
+        struct Slot {
+            std::atomic<uint64_t> m_sequence   = 0;
+            std::atomic<TimerId> m_timer_id    = 0;
+            std::atomic<int64_t> m_start_ticks = 0;
+            std::atomic<int64_t> m_stop_ticks  = 0;
+        };
+
+        std::vector<Slot> m_slots;
+        std::atomic<uint64_t> m_written_count = 0;
+        const uint32_t m_thread_index;
+    };
+
+    // Timers results are accumulated separately by every thread, so timers running in different threads
+    // don't compete for a common lock. The results of all threads are merged only when they are requested
+    // (GetCurrentResults) or when the thread is finished.
     class ProfilerAggregator {
     public:
-        using TimersResults = std::unordered_map<std::string, TimerResult>;
+        using TimersResults = CU::TimersResults;
 
-        static void Setup(
-            // TODO: configuration
-        ) {
-            static ProfilerAggregator profiler{};
+        static void Setup(const ProfilerConfiguration& configuration = {}) {
+            static ProfilerAggregator profiler{ configuration };
         }
 
         ProfilerAggregator(const ProfilerAggregator&)            = delete;
@@ -102,66 +664,317 @@ namespace CU {
         ProfilerAggregator& operator=(const ProfilerAggregator&) = delete;
         ProfilerAggregator& operator=(ProfilerAggregator&&)      = delete;
 
-        ~ProfilerAggregator() {
-            // TODO: ability to use a logging system depending on the configuration.
-            constexpr std::ostream& out = std::cout;
+        ~ProfilerAggregator();
 
-            out << "Profiler results:" << std::endl;
+        // Returns the identifier of the timer with the given full name.
+        // The same identifier is returned for the same name.
+        static TimerId RegisterTimer(std::string timer_name);
 
-            std::scoped_lock _(m_timer_results_lock);
-            for (const auto& [timer_id, timer_result] : m_timer_results) {
-                out << timer_id << ":" << std::endl;
-                out << timer_result << std::endl;
-            }
+        // Opens the scope of the timer in the call tree of the current thread.
+        // Returns CallTree::INVALID_NODE if the call tree isn't collected.
+        static CallTree::NodeIndex EnterScope(TimerId timer_id) {
+            if (!m_collect_call_tree.load(std::memory_order_relaxed))
+                return CallTree::INVALID_NODE;
+
+            return GetThreadResults().EnterScope(timer_id);
         }
 
-        static void NotifyTimer(const std::string& timer_id, int64_t duration_ns) {
-            std::scoped_lock _(m_timer_results_lock);
-            m_timer_results[timer_id].StoreDuration(duration_ns);
+        static void NotifyTimer(TimerId timer_id, int64_t duration_ns,
+                                CallTree::NodeIndex call_node = CallTree::INVALID_NODE,
+                                const HardwareCounters* counters = nullptr) {
+            GetThreadResults().StoreDuration(timer_id, duration_ns, call_node, counters);
         }
 
-        static TimersResults GetCurrentResults() {
-            std::scoped_lock _(m_timer_results_lock);
-            return m_timer_results;
+        static void NotifyUntimedActivation(TimerId timer_id) {
+            GetThreadResults().StoreUntimedActivation(timer_id);
         }
 
+        // Reads hardware counters of the current thread.
+        // Returns false if they aren't collected or unavailable.
+        static bool ReadHardwareCounters(HardwareCounters& counters) {
+            if (!m_collect_hardware_counters.load(std::memory_order_relaxed))
+                return false;
+
+            return GetThreadResults().ReadHardwareCounters(counters);
+        }
+
+        static void TraceTimer(TimerId timer_id, int64_t start_ticks, int64_t stop_ticks) {
+            if (!m_trace_buffer_capacity.load(std::memory_order_relaxed))
+                return;
+
+            GetThreadResults().PushTraceEvent(timer_id, start_ticks, stop_ticks);
+        }
+
+        // Consistent view of the results of all timers.
+        // The results are copied under the registry lock when the snapshot is created, the snapshot itself
+        // doesn't hold any lock: timers can be registered and activated while it exists.
+        class ResultsSnapshot {
+        public:
+            ResultsSnapshot(const ResultsSnapshot&)            = delete;
+            ResultsSnapshot(ResultsSnapshot&&)                 = default;
+            ResultsSnapshot& operator=(const ResultsSnapshot&) = delete;
+            ResultsSnapshot& operator=(ResultsSnapshot&&)      = default;
+
+            // Calls visitor(std::string_view name, const TimerResult& result) for every activated timer
+            // whose name starts with prefix, in the order of names.
+            template<typename Visitor>
+            void Visit(std::string_view prefix, Visitor&& visitor) const {
+                for (auto it = FindFirstTimer(prefix); m_results.end() != it && it->first.starts_with(prefix); ++it) {
+                    visitor(it->first, it->second);
+                }
+            }
+
+            // Returns the result of the first activated timer (in the order of names) whose name starts with prefix,
+            // nullptr if there is no such timer. The result is valid while the snapshot exists.
+            const TimerResult* FindFirst(std::string_view prefix) const {
+                const auto it = FindFirstTimer(prefix);
+                if (m_results.end() == it || !it->first.starts_with(prefix))
+                    return nullptr;
+
+                return &it->second;
+            }
+
+        private:
+            friend class ProfilerAggregator;
+            // only timers whose names start with one of the prefixes are copied, all timers if there are no prefixes
+            explicit ResultsSnapshot(const std::vector<std::string_view>& prefixes = {});
+
+            using SortedTimers = std::vector<std::pair<std::string_view, TimerId>>;
+            // names are the keys of the registry, they are never removed
+            using SortedResults = std::vector<std::pair<std::string_view, TimerResult>>;
+
+            SortedResults::const_iterator FindFirstTimer(std::string_view prefix) const {
+                return std::lower_bound(m_results.begin(), m_results.end(), prefix,
+                    [](const SortedResults::value_type& timer, std::string_view key) { return timer.first < key; });
+            }
+
+            // activated timers only
+            SortedResults m_results;
+        };
+
+        static ResultsSnapshot GetResultsSnapshot() { return ResultsSnapshot(); }
+
+        static TimersResults GetCurrentResults();
+
+        static std::string GetTimerName(TimerId timer_id);
+
+        static CallTree GetCallTree();
+        static void WriteCollapsedStacks(std::ostream& os);
+
+        // The events of finished threads are written once, they are released after the writing.
+        static void WriteTrace(std::ostream& os);
+        // Returns false if the file can't be written.
+        static bool WriteTrace(const std::filesystem::path& file_name);
+
         template<typename StrKeyContainer>
             requires std::ranges::range<StrKeyContainer> &&
                      std::is_convertible_v<std::ranges::range_value_t<StrKeyContainer>, std::string>
         static TimersResults GetCurrentResults(StrKeyContainer&& filter) {
-            auto all_results = GetCurrentResults();
-
             TimersResults filtered_results;
+            const std::vector<std::string> keys(std::ranges::begin(filter), std::ranges::end(filter));
+            // only the results of the filtered timers are copied
+            const ResultsSnapshot snapshot(std::vector<std::string_view>(keys.begin(), keys.end()));
 
-            for (const std::string& key : filter) {
-                auto has_selected_key = [key](const TimersResults::value_type& node) {
-                    return node.first.compare(0, key.size(), key) == 0;
-                    };
-
-                const auto key_result = std::find_if(
-                    all_results.begin(),
-                    all_results.end(),
-                    has_selected_key);
+            for (const auto& key : keys) {
+                const auto key_result = snapshot.FindFirst(key);
 
-                if (all_results.end() == key_result) {
-                    // TODO: ability to use a logging system depending on the configuration.
-                    constexpr std::ostream& out = std::cout;
-                    out << "Key <" << key << "> not found in timers results" << std::endl;
+                // keys not found in the results are absent in the filtered results
+                if (!key_result)
                     continue;
-                }
 
-                filtered_results[key] = key_result->second;
+                filtered_results[key] = *key_result;
             }
             return filtered_results;
         }
 
     private:
-        ProfilerAggregator(
-            // TODO: configuration
-        ) = default;
+        explicit ProfilerAggregator(const ProfilerConfiguration& configuration);
+
+        // Writes the report of activations finished since the previous call to all sinks
+        void WriteIntervalReport();
+        void RunReporter();
+
+        // Results of the timers of a single thread.
+        // The lock is taken by another thread only while merging the results, so it's almost never contended.
+        class ThreadTimersResults {
+        public:
+            ThreadTimersResults();
+            ~ThreadTimersResults();
+
+            ThreadTimersResults(const ThreadTimersResults&)            = delete;
+            ThreadTimersResults(ThreadTimersResults&&)                 = delete;
+            ThreadTimersResults& operator=(const ThreadTimersResults&) = delete;
+            ThreadTimersResults& operator=(ThreadTimersResults&&)      = delete;
+
+            // the tree is modified only by the owner thread, so it's read without lock here
+            CallTree::NodeIndex EnterScope(TimerId timer_id) {
+                const auto parent = m_scope_stack.back();
+
+                auto node = m_call_tree.FindChild(parent, timer_id);
+                if (CallTree::INVALID_NODE == node) {
+                    std::scoped_lock _(m_results_lock);
+                    node = m_call_tree.AddChild(parent, timer_id);
+                }
+
+                m_scope_stack.push_back(node);
+                return node;
+            }
+
+            void StoreDuration(TimerId timer_id, int64_t duration_ns, CallTree::NodeIndex call_node,
+                               const HardwareCounters* counters) {
+                std::scoped_lock _(m_results_lock);
+                if (m_results.size() <= timer_id)
+                    m_results.resize(timer_id + 1);
+
+                auto& timer_result = m_results[timer_id];
+                if (!timer_result.m_histogram && m_collect_histograms.load(std::memory_order_relaxed))
+                    timer_result.m_histogram = std::make_unique<LatencyHistogram>();
+                timer_result.StoreDuration(duration_ns);
+                if (counters)
+                    timer_result.StoreHardwareCounters(*counters);
+
+                if (CallTree::INVALID_NODE != call_node) {
+                    m_call_tree.StoreDuration(call_node, duration_ns);
+
+                    // closes the scope of the timer and the scopes of nested timers that are still running
+                    const auto depth = m_call_tree.GetNode(call_node).m_depth;
+                    if (m_scope_stack.size() > depth)
+                        m_scope_stack.resize(depth);
+                }
+            }
+
+            // the owner thread is the only writer of the counts, so they are updated without lock
+            void StoreUntimedActivation(TimerId timer_id) {
+                if (m_untimed_counts.size() <= timer_id) {
+                    std::scoped_lock _(m_results_lock);
+                    m_untimed_counts.resize(timer_id + 1);
+                }
+
+                std::atomic_ref<int64_t> untimed_count(m_untimed_counts[timer_id]);
+                untimed_count.store(untimed_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+
+            // the counters are opened on the first call, by the owner thread
+            bool ReadHardwareCounters(HardwareCounters& counters) {
+                if (!m_counters_reader)
+                    m_counters_reader = std::make_unique<HardwareCountersReader>();
+                return m_counters_reader->Read(counters);
+            }
+
+            void PushTraceEvent(TimerId timer_id, int64_t start_ticks, int64_t stop_ticks) {
+                // the buffer is allocated once, on the first event of the thread
+                if (!m_trace_buffer) {
+                    std::scoped_lock _(m_results_lock);
+                    m_trace_buffer = std::make_unique<TraceBuffer>(
+                        m_trace_buffer_capacity.load(std::memory_order_relaxed), m_thread_index);
+                }
+                m_trace_buffer->Push(timer_id, start_ticks, stop_ticks);
+            }
+
+            void MergeTo(std::vector<TimerResult>& results) const;
+            // results[i] receives the results of the timer timers_ids[i]
+            void MergeTo(const std::vector<TimerId>& timers_ids, std::vector<TimerResult>& results) const;
+            void MergeTo(CallTree& call_tree) const;
+
+            // Moves the results collected since the previous call to the given tables.
+            // The live table is swapped with the spare one, so the owner thread waits only for the swap.
+            // Called only by the reporter, under the registry lock.
+            void FlushTo(std::vector<TimerResult>& results);
+            void CopyTo(std::vector<TraceEvent>& events) const;
+
+            uint32_t GetThreadIndex() const { return m_thread_index; }
+
+        private:
+            mutable std::mutex m_results_lock;
+            std::vector<TimerResult> m_results;
+            // reset results swapped with m_results by the reporter, keeps allocations of the live table
+            std::vector<TimerResult> m_spare_results;
+            CallTree m_call_tree;
+
+            // path of the running timers in the call tree, owned by the thread
+            std::vector<CallTree::NodeIndex> m_scope_stack{ CallTree::ROOT_NODE };
+
+            std::unique_ptr<TraceBuffer> m_trace_buffer;
+            uint32_t m_thread_index = 0;
+
+            std::unique_ptr<HardwareCountersReader> m_counters_reader;
+
+            // activations skipped by sampling, only growing, accessed by std::atomic_ref
+            std::vector<int64_t> m_untimed_counts;
+            // part of m_untimed_counts already flushed by the reporter
+            std::vector<int64_t> m_flushed_untimed_counts;
+        };
+
+        static ThreadTimersResults& GetThreadResults() {
+            thread_local ThreadTimersResults thread_results;
+            return thread_results;
+        }
+
+        static std::atomic<bool> m_collect_histograms;
+        static std::atomic<bool> m_collect_call_tree;
+        static std::atomic<size_t> m_trace_buffer_capacity;
+        static std::atomic<bool> m_collect_hardware_counters;
 
         static std::mutex m_timer_results_lock;
-        static TimersResults m_timer_results;
+        static std::unordered_map<std::string, TimerId> m_timers_ids;
+        static std::vector<std::string> m_timers_names;
+        // results already written by the interval reports
+        static std::vector<TimerResult> m_timer_results;
+        // results of finished threads and results flushed from the threads tables, not reported yet
+        static std::vector<TimerResult> m_interval_results;
+        static CallTree m_call_tree;
+        static std::vector<ThreadTimersResults*> m_threads_results;
+        // names of all timers in sorted order (views of m_timers_ids keys), the prefix index of results
+        static ResultsSnapshot::SortedTimers m_sorted_timers;
+        // events of finished threads (thread index, event), only the latest m_trace_buffer_capacity of them are kept
+        static std::deque<std::pair<uint32_t, TraceEvent>> m_retired_trace_events;
+        static uint32_t m_threads_count;
+
+        const ProfilerConfiguration m_configuration;
+        std::vector<std::shared_ptr<ProfilerSink>> m_sinks;
+
+        std::mutex m_reporter_lock;
+        std::condition_variable m_reporter_stop_condition;
+        bool m_is_reporter_stopped = false;
+        std::chrono::steady_clock::time_point m_start;
+        std::chrono::steady_clock::time_point m_interval_start;
+        std::thread m_reporter;
+    };
+
+    // Description of the code block measured by timers.
+    // The identifiers of the timers created at the site are registered only once:
+    // the identifier of the site itself - on construction, the identifiers for KEY - on the first use of the key.
+    // A keyed site doesn't register its own timer, it gets the index of its keys in the per-thread caches,
+    // so the caches own the keys and don't refer to the site.
+    class TimerSite {
+    public:
+        TimerSite(const TimerSite&)            = delete;
+        TimerSite(TimerSite&&)                 = delete;
+        TimerSite& operator=(const TimerSite&) = delete;
+        TimerSite& operator=(TimerSite&&)      = delete;
+
+        TimerSite(
+            std::string_view _prefix,
+            std::string_view _file,
+            size_t _file_prefix_length,
+            int _line,
+            std::string_view _function,
+            bool _is_keyed = false);
+
+        // only for the sites which aren't keyed
+        TimerId GetId() const {
+            assert(!m_is_keyed);
+            return m_id;
+        }
+
+        // only for the keyed sites
+        TimerId GetKeyId(std::string_view key) const;
+
+    private:
+        std::string m_location;
+        bool        m_is_keyed;
+        // the timer of the site or the index of the keyed site
+        uint32_t    m_id;
     };
 
     class CheckBlockTimer {
@@ -171,39 +984,67 @@ namespace CU {
         CheckBlockTimer& operator=(const CheckBlockTimer&) = delete;
         CheckBlockTimer& operator=(CheckBlockTimer&&)      = delete;
 
-        CheckBlockTimer(
-            const std::string& _prefix,
-            const std::string& _file,
-            int _line,
-            const std::string& _function) :
-            m_identifier(_prefix + _file + ", " + std::to_string(_line) + " - " + _function),
-            m_start_time(clock::now()) {}
+        // if the activation isn't timed, it's only counted
+        explicit CheckBlockTimer(TimerId _timer_id, bool _is_timed = true) :
+            m_timer_id(_timer_id),
+            m_call_node(_is_timed ? ProfilerAggregator::EnterScope(_timer_id) : CallTree::INVALID_NODE),
+            m_is_counted(_is_timed && ProfilerAggregator::ReadHardwareCounters(m_start_counters)),
+            m_start_ticks(_is_timed ? ProfilerClock::Now() : 0),
+            m_is_stopped(!_is_timed) {
+            if (!_is_timed)
+                ProfilerAggregator::NotifyUntimedActivation(_timer_id);
+        }
+
+        // Returns true for 1 in rate calls with the same counter, starting from the first one.
+        static bool IsSampled(uint64_t& counter, uint64_t rate) {
+            if (counter) {
+                counter--;
+                return false;
+            }
+
+            counter = rate > 1 ? rate - 1 : 0;
+            return true;
+        }
 
         ~CheckBlockTimer() { Stop(); }
 
         void Stop() {
             if (m_is_stopped) return;
 
-            auto elapsed_time_ns = std::chrono::duration_cast<nano>(clock::now() - m_start_time).count();
+            const auto stop_ticks = ProfilerClock::Now();
+            auto elapsed_ticks = std::max(stop_ticks - m_start_ticks, int64_t(0));
+            auto elapsed_time_ns = ProfilerClock::ToNanoseconds(elapsed_ticks);
             m_is_stopped = true;
 
-            ProfilerAggregator::NotifyTimer(m_identifier, elapsed_time_ns);
+            HardwareCounters counters;
+            if (m_is_counted && ProfilerAggregator::ReadHardwareCounters(counters)) {
+                counters = counters - m_start_counters;
+                ProfilerAggregator::NotifyTimer(m_timer_id, elapsed_time_ns, m_call_node, &counters);
+            }
+            else {
+                ProfilerAggregator::NotifyTimer(m_timer_id, elapsed_time_ns, m_call_node);
+            }
+            ProfilerAggregator::TraceTimer(m_timer_id, m_start_ticks, stop_ticks);
         }
 
     private:
-        using nano = std::chrono::nanoseconds;
-        using clock = std::chrono::steady_clock;
-
-        const std::string       m_identifier;
-        const clock::time_point m_start_time;
+        const TimerId             m_timer_id;
+        const CallTree::NodeIndex m_call_node;
+        HardwareCounters          m_start_counters;
+        const bool                m_is_counted;
+        const int64_t             m_start_ticks;
 
-        bool m_is_stopped = false;
+        bool m_is_stopped;
     };
 }
 
 #else
 #define USE_CU_PROFILE
+#define USE_CU_PROFILE_CONFIG(...)
 #define CU_PROFILE_CHECKBLOCK(...)
+#define CU_PROFILE_CHECKBLOCK_SAMPLED(RATE, ...)
 #define CU_STOP_CHECKBLOCK(NAME)
 #define CU_PROFILE_GET_RESULTS() {}
+#define CU_PROFILE_WRITE_CALL_TREE(STREAM)
+#define CU_PROFILE_WRITE_TRACE(STREAM)
 #endif
@@ -0,0 +1,30 @@
+// Copyright (c) 2025, Yakov Usoltsev
+// Email: yakovmen62@gmail.com
+//
+// License: MIT
+
+#pragma once
+
+// Vectorized math kernels over float arrays, the library common-utils-simd-math (ENABLE_CU_SIMD_MATH).
+// Every kernel is compiled into the units DEF, SSE4_2, AVX2 and AVX512 by generate_simd_compile_units,
+// the entry point CU::Math::<name> calls the best variant supported by the current CPU
+// and the variants CU::Math::<name>_<set> may be called directly (see CU::SimdFunction).
+//
+// reductions
+//      float   sum(values, size)
+//      float   dot(lhs, rhs, size)
+//      float   min(values, size), max(values, size)
+//      int64_t argmax(values, size)
+// elementwise
+//      void    axpy(alpha, x, y, size)                 - y = alpha * x + y
+//      void    exp(values, size, results), log(...), tanh(...)
+// comparison
+//      bool    is_equal(lhs, rhs, size, absolute_epsilon, relative_epsilon)
+//
+// The interface and the details are in src/simd-math/simd_math_iface.hpp.
+
+#if defined(ENABLE_CU_SIMD_MATH)
+
+#include "simd_math.hpp"
+
+#endif
@@ -26,13 +26,37 @@
 #    define FUNC_POSTFIX avx2
 #  elif defined(CU_COMPILE_UNIT_AVX512)
 #    define FUNC_POSTFIX avx512
-//  TODO: we need specific compile_unit for some avx512 instructions set
-//  TODO: ARM
+#    define CU_COMPILE_UNIT_AVX512_FAMILY
+//  profiles of AVX512 instructions sets (see CU::InstructionsProfile)
+#  elif defined(CU_COMPILE_UNIT_X86_64_V4)
+#    define FUNC_POSTFIX x86_64_v4
+#    define CU_COMPILE_UNIT_AVX512_FAMILY
+#  elif defined(CU_COMPILE_UNIT_AVX512_VNNI)
+#    define FUNC_POSTFIX avx512_vnni
+#    define CU_COMPILE_UNIT_AVX512_FAMILY
+#  elif defined(CU_COMPILE_UNIT_AVX512_FP16)
+#    define FUNC_POSTFIX avx512_fp16
+#    define CU_COMPILE_UNIT_AVX512_FAMILY
+#  elif defined(CU_COMPILE_UNIT_NEON)
+#    define FUNC_POSTFIX neon
+#  elif defined(CU_COMPILE_UNIT_SVE)
+#    define FUNC_POSTFIX sve
+#    define CU_COMPILE_UNIT_SVE_FAMILY
+#  elif defined(CU_COMPILE_UNIT_SVE2)
+#    define FUNC_POSTFIX sve2
+#    define CU_COMPILE_UNIT_SVE_FAMILY
 #  else // CU_COMPILE_UNIT_DEF or just default implementation
 #    define FUNC_POSTFIX def
 #  endif // CU_COMPILE_UNIT_*
 #endif // CU_BUILD_SPECIFIC_SIMD
 
+// macro CU_COMPILE_UNIT_AVX512_FAMILY
+// Description: Defined for every compile unit that supports at least AVX512F (AVX512 and its profiles),
+//              so they can share the same implementation.
+
+// macro CU_COMPILE_UNIT_SVE_FAMILY
+// Description: Defined for SVE and SVE2 compile units, they share the vector length agnostic implementation.
+
 // macro CU_SIMD(name)
 // Description: Generates an identifier with a postfix corresponding to the current compilation unit.
 //              The format of the compilation unit is defined by the macro CU_COMPILE_UNIT_<current instruction set>.
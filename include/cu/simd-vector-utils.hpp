@@ -0,0 +1,840 @@
+// Copyright (c) 2025, Yakov Usoltsev
+// Email: yakovmen62@gmail.com
+//
+// License: MIT
+
+#pragma once
+
+// Portable SIMD vectors for the compile units generated by generate_simd_compile_units.
+// The width and the intrinsics are chosen by the define CU_COMPILE_UNIT_<current instruction set>:
+//  AVX512 and its profiles  - 512-bit vectors
+//  AVX2                     - 256-bit vectors
+//  SSE4_1, SSE4_2 and AVX   - 128-bit vectors
+//  other units              - scalar "vectors" of one lane, the compiler is free to vectorize them,
+//                             this includes the AArch64 units (NEON, SVE, SVE2): their kernels are
+//                             auto-vectorized for the -march of the unit
+// so one kernel written with CU::Simd::Vector compiles into all the units.
+//
+// Vectors of float, double and int32_t use the registers, vectors of other types have one lane.
+//
+// The types live in the inline namespace named after the compile unit (e.g. CU::Simd::unit_avx2),
+// so the inline functions of different units are not merged by the linker.
+// All the compile units with the same postfix must be compiled with the same flags.
+
+#include <cu/simd-utils.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <cstdlib>
+#include <bit>
+#include <type_traits>
+
+#if defined(CU_COMPILE_UNIT_AVX512_FAMILY)
+#  include <immintrin.h>
+#  define CU_SIMD_VECTOR_AVX512
+#elif defined(CU_COMPILE_UNIT_AVX2)
+#  include <immintrin.h>
+#  define CU_SIMD_VECTOR_AVX2
+#elif defined(CU_COMPILE_UNIT_SSE4_1) || defined(CU_COMPILE_UNIT_SSE4_2) || defined(CU_COMPILE_UNIT_AVX)
+#  include <smmintrin.h>
+#  define CU_SIMD_VECTOR_SSE4
+#endif // CU_COMPILE_UNIT_*
+
+namespace CU::Simd {
+inline namespace CU_SIMD(unit) {
+
+#if defined(CU_SIMD_VECTOR_AVX512)
+    static constexpr const char* VECTOR_BACKEND = "AVX512";
+    static constexpr int64_t VECTOR_BYTES = 64;
+#elif defined(CU_SIMD_VECTOR_AVX2)
+    static constexpr const char* VECTOR_BACKEND = "AVX2";
+    static constexpr int64_t VECTOR_BYTES = 32;
+#elif defined(CU_SIMD_VECTOR_SSE4)
+    static constexpr const char* VECTOR_BACKEND = "SSE4";
+    static constexpr int64_t VECTOR_BYTES = 16;
+#else
+    static constexpr const char* VECTOR_BACKEND = "SCALAR";
+    static constexpr int64_t VECTOR_BYTES = 0;
+#endif // CU_SIMD_VECTOR_*
+
+    namespace PrivateImplementation {
+        // Traits describe the registers of the backend and the operations on them.
+        // Gather and LoadPartial/StorePartial are optional, Vector emulates them if they are missing.
+
+        template<typename T>
+        struct ScalarTraits {
+            using Register = T;
+            using MaskRegister = bool;
+            static constexpr int64_t LANES = 1;
+
+            static Register Zero() { return T(0); }
+            static Register Broadcast(T value) { return value; }
+            static Register Load(const T* values) { return *values; }
+            static void Store(T* values, Register value) { *values = value; }
+
+            static Register Add(Register lhs, Register rhs) { return lhs + rhs; }
+            static Register Sub(Register lhs, Register rhs) { return lhs - rhs; }
+            static Register Mul(Register lhs, Register rhs) { return lhs * rhs; }
+            static Register Div(Register lhs, Register rhs) { return lhs / rhs; }
+            // if any argument is NaN, the second one is returned as by SSE/AVX
+            static Register Min(Register lhs, Register rhs) { return lhs < rhs ? lhs : rhs; }
+            static Register Max(Register lhs, Register rhs) { return lhs > rhs ? lhs : rhs; }
+            static Register MulAdd(Register lhs, Register rhs, Register addend) { return lhs * rhs + addend; }
+            static Register Abs(Register value) {
+                if constexpr (std::is_floating_point_v<T>)
+                    return std::abs(value);
+                else
+                    return value < T(0) ? T(0 - value) : value;
+            }
+            static Register Sqrt(Register value) { return T(std::sqrt(value)); }
+
+            static MaskRegister Equal(Register lhs, Register rhs) { return lhs == rhs; }
+            static MaskRegister Less(Register lhs, Register rhs) { return lhs < rhs; }
+            static MaskRegister LessEqual(Register lhs, Register rhs) { return lhs <= rhs; }
+            static Register Select(MaskRegister mask, Register lhs, Register rhs) { return mask ? lhs : rhs; }
+
+            static MaskRegister MaskAnd(MaskRegister lhs, MaskRegister rhs) { return lhs && rhs; }
+            static MaskRegister MaskOr(MaskRegister lhs, MaskRegister rhs) { return lhs || rhs; }
+            static MaskRegister MaskNot(MaskRegister mask) { return !mask; }
+            static uint64_t MaskBits(MaskRegister mask) { return mask ? 1 : 0; }
+
+            static Register Gather(const T* values, const int32_t* indices) { return values[*indices]; }
+
+            // floating point only
+            static Register Round(Register value) { return std::nearbyint(value); }
+            static int32_t ToInt32(Register value) { return int32_t(value); }
+            static Register FromInt32(int32_t value) { return T(value); }
+            static int32_t BitsToInt32(Register value) { return std::bit_cast<int32_t>(value); }
+            static Register BitsFromInt32(int32_t value) { return std::bit_cast<T>(value); }
+
+            // integer only
+            static Register And(Register lhs, Register rhs) { return lhs & rhs; }
+            static Register Or(Register lhs, Register rhs) { return lhs | rhs; }
+            static Register Xor(Register lhs, Register rhs) { return lhs ^ rhs; }
+            template<int COUNT>
+            static Register ShiftLeft(Register value) { return T(std::make_unsigned_t<T>(value) << COUNT); }
+            template<int COUNT>
+            static Register ShiftRight(Register value) { return T(value >> COUNT); }
+        };
+
+        template<typename T>
+        struct VectorTraits : ScalarTraits<T> {};
+
+#if defined(CU_SIMD_VECTOR_AVX512)
+        template<>
+        struct VectorTraits<float> {
+            using Register = __m512;
+            using MaskRegister = __mmask16;
+            static constexpr int64_t LANES = 16;
+
+            static Register Zero() { return _mm512_setzero_ps(); }
+            static Register Broadcast(float value) { return _mm512_set1_ps(value); }
+            static Register Load(const float* values) { return _mm512_loadu_ps(values); }
+            static void Store(float* values, Register value) { _mm512_storeu_ps(values, value); }
+            static Register LoadPartial(const float* values, int64_t count) {
+                return _mm512_maskz_loadu_ps(MaskRegister((1u << count) - 1), values);
+            }
+            static void StorePartial(float* values, Register value, int64_t count) {
+                _mm512_mask_storeu_ps(values, MaskRegister((1u << count) - 1), value);
+            }
+
+            static Register Add(Register lhs, Register rhs) { return _mm512_add_ps(lhs, rhs); }
+            static Register Sub(Register lhs, Register rhs) { return _mm512_sub_ps(lhs, rhs); }
+            static Register Mul(Register lhs, Register rhs) { return _mm512_mul_ps(lhs, rhs); }
+            static Register Div(Register lhs, Register rhs) { return _mm512_div_ps(lhs, rhs); }
+            // the masked forms with the full mask here and below, the plain ones use an undefined register,
+            // which GCC 12 reports as uninitialized in optimized builds
+            static Register Min(Register lhs, Register rhs) { return _mm512_mask_min_ps(lhs, 0xFFFF, lhs, rhs); }
+            static Register Max(Register lhs, Register rhs) { return _mm512_mask_max_ps(lhs, 0xFFFF, lhs, rhs); }
+            static Register MulAdd(Register lhs, Register rhs, Register addend) { return _mm512_fmadd_ps(lhs, rhs, addend); }
+            static Register Abs(Register value) { return _mm512_abs_ps(value); }
+            static Register Sqrt(Register value) { return _mm512_maskz_sqrt_ps(0xFFFF, value); }
+
+            static MaskRegister Equal(Register lhs, Register rhs) { return _mm512_cmp_ps_mask(lhs, rhs, _CMP_EQ_OQ); }
+            static MaskRegister Less(Register lhs, Register rhs) { return _mm512_cmp_ps_mask(lhs, rhs, _CMP_LT_OQ); }
+            static MaskRegister LessEqual(Register lhs, Register rhs) { return _mm512_cmp_ps_mask(lhs, rhs, _CMP_LE_OQ); }
+            static Register Select(MaskRegister mask, Register lhs, Register rhs) { return _mm512_mask_blend_ps(mask, rhs, lhs); }
+
+            static MaskRegister MaskAnd(MaskRegister lhs, MaskRegister rhs) { return MaskRegister(lhs & rhs); }
+            static MaskRegister MaskOr(MaskRegister lhs, MaskRegister rhs) { return MaskRegister(lhs | rhs); }
+            static MaskRegister MaskNot(MaskRegister mask) { return MaskRegister(~mask); }
+            static uint64_t MaskBits(MaskRegister mask) { return mask; }
+
+            static Register Round(Register value) { return _mm512_maskz_roundscale_ps(0xFFFF, value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+            static __m512i ToInt32(Register value) { return _mm512_maskz_cvttps_epi32(0xFFFF, value); }
+            static Register FromInt32(__m512i value) { return _mm512_maskz_cvtepi32_ps(0xFFFF, value); }
+            static __m512i BitsToInt32(Register value) { return _mm512_castps_si512(value); }
+            static Register BitsFromInt32(__m512i value) { return _mm512_castsi512_ps(value); }
+
+            static Register Gather(const float* values, const int32_t* indices) {
+                return _mm512_mask_i32gather_ps(Zero(), 0xFFFF, _mm512_loadu_si512(indices), values, sizeof(float));
+            }
+        };
+
+        template<>
+        struct VectorTraits<double> {
+            using Register = __m512d;
+            using MaskRegister = __mmask8;
+            static constexpr int64_t LANES = 8;
+
+            static Register Zero() { return _mm512_setzero_pd(); }
+            static Register Broadcast(double value) { return _mm512_set1_pd(value); }
+            static Register Load(const double* values) { return _mm512_loadu_pd(values); }
+            static void Store(double* values, Register value) { _mm512_storeu_pd(values, value); }
+            static Register LoadPartial(const double* values, int64_t count) {
+                return _mm512_maskz_loadu_pd(MaskRegister((1u << count) - 1), values);
+            }
+            static void StorePartial(double* values, Register value, int64_t count) {
+                _mm512_mask_storeu_pd(values, MaskRegister((1u << count) - 1), value);
+            }
+
+            static Register Add(Register lhs, Register rhs) { return _mm512_add_pd(lhs, rhs); }
+            static Register Sub(Register lhs, Register rhs) { return _mm512_sub_pd(lhs, rhs); }
+            static Register Mul(Register lhs, Register rhs) { return _mm512_mul_pd(lhs, rhs); }
+            static Register Div(Register lhs, Register rhs) { return _mm512_div_pd(lhs, rhs); }
+            // the masked forms, as for float
+            static Register Min(Register lhs, Register rhs) { return _mm512_mask_min_pd(lhs, 0xFF, lhs, rhs); }
+            static Register Max(Register lhs, Register rhs) { return _mm512_mask_max_pd(lhs, 0xFF, lhs, rhs); }
+            static Register MulAdd(Register lhs, Register rhs, Register addend) { return _mm512_fmadd_pd(lhs, rhs, addend); }
+            static Register Abs(Register value) { return _mm512_abs_pd(value); }
+            static Register Sqrt(Register value) { return _mm512_maskz_sqrt_pd(0xFF, value); }
+
+            static MaskRegister Equal(Register lhs, Register rhs) { return _mm512_cmp_pd_mask(lhs, rhs, _CMP_EQ_OQ); }
+            static MaskRegister Less(Register lhs, Register rhs) { return _mm512_cmp_pd_mask(lhs, rhs, _CMP_LT_OQ); }
+            static MaskRegister LessEqual(Register lhs, Register rhs) { return _mm512_cmp_pd_mask(lhs, rhs, _CMP_LE_OQ); }
+            static Register Select(MaskRegister mask, Register lhs, Register rhs) { return _mm512_mask_blend_pd(mask, rhs, lhs); }
+
+            static MaskRegister MaskAnd(MaskRegister lhs, MaskRegister rhs) { return MaskRegister(lhs & rhs); }
+            static MaskRegister MaskOr(MaskRegister lhs, MaskRegister rhs) { return MaskRegister(lhs | rhs); }
+            static MaskRegister MaskNot(MaskRegister mask) { return MaskRegister(~mask); }
+            static uint64_t MaskBits(MaskRegister mask) { return mask; }
+
+            static Register Round(Register value) { return _mm512_maskz_roundscale_pd(0xFF, value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+            static Register Gather(const double* values, const int32_t* indices) {
+                return _mm512_mask_i32gather_pd(Zero(), 0xFF, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices)), values, sizeof(double));
+            }
+        };
+
+        template<>
+        struct VectorTraits<int32_t> {
+            using Register = __m512i;
+            using MaskRegister = __mmask16;
+            static constexpr int64_t LANES = 16;
+
+            static Register Zero() { return _mm512_setzero_si512(); }
+            static Register Broadcast(int32_t value) { return _mm512_set1_epi32(value); }
+            static Register Load(const int32_t* values) { return _mm512_loadu_si512(values); }
+            static void Store(int32_t* values, Register value) { _mm512_storeu_si512(values, value); }
+            static Register LoadPartial(const int32_t* values, int64_t count) {
+                return _mm512_maskz_loadu_epi32(MaskRegister((1u << count) - 1), values);
+            }
+            static void StorePartial(int32_t* values, Register value, int64_t count) {
+                _mm512_mask_storeu_epi32(values, MaskRegister((1u << count) - 1), value);
+            }
+
+            static Register Add(Register lhs, Register rhs) { return _mm512_add_epi32(lhs, rhs); }
+            static Register Sub(Register lhs, Register rhs) { return _mm512_sub_epi32(lhs, rhs); }
+            static Register Mul(Register lhs, Register rhs) { return _mm512_mullo_epi32(lhs, rhs); }
+            static Register Min(Register lhs, Register rhs) { return _mm512_maskz_min_epi32(0xFFFF, lhs, rhs); }
+            static Register Max(Register lhs, Register rhs) { return _mm512_maskz_max_epi32(0xFFFF, lhs, rhs); }
+            static Register MulAdd(Register lhs, Register rhs, Register addend) { return Add(Mul(lhs, rhs), addend); }
+            static Register Abs(Register value) { return _mm512_maskz_abs_epi32(0xFFFF, value); }
+
+            static MaskRegister Equal(Register lhs, Register rhs) { return _mm512_cmpeq_epi32_mask(lhs, rhs); }
+            static MaskRegister Less(Register lhs, Register rhs) { return _mm512_cmplt_epi32_mask(lhs, rhs); }
+            static MaskRegister LessEqual(Register lhs, Register rhs) { return _mm512_cmple_epi32_mask(lhs, rhs); }
+            static Register Select(MaskRegister mask, Register lhs, Register rhs) { return _mm512_mask_blend_epi32(mask, rhs, lhs); }
+
+            static MaskRegister MaskAnd(MaskRegister lhs, MaskRegister rhs) { return MaskRegister(lhs & rhs); }
+            static MaskRegister MaskOr(MaskRegister lhs, MaskRegister rhs) { return MaskRegister(lhs | rhs); }
+            static MaskRegister MaskNot(MaskRegister mask) { return MaskRegister(~mask); }
+            static uint64_t MaskBits(MaskRegister mask) { return mask; }
+
+            static Register And(Register lhs, Register rhs) { return _mm512_and_si512(lhs, rhs); }
+            static Register Or(Register lhs, Register rhs) { return _mm512_or_si512(lhs, rhs); }
+            static Register Xor(Register lhs, Register rhs) { return _mm512_xor_si512(lhs, rhs); }
+            template<int COUNT>
+            static Register ShiftLeft(Register value) { return _mm512_maskz_slli_epi32(0xFFFF, value, COUNT); }
+            template<int COUNT>
+            static Register ShiftRight(Register value) { return _mm512_maskz_srai_epi32(0xFFFF, value, COUNT); }
+
+            static Register Gather(const int32_t* values, const int32_t* indices) {
+                return _mm512_mask_i32gather_epi32(Zero(), 0xFFFF, _mm512_loadu_si512(indices), values, sizeof(int32_t));
+            }
+        };
+#endif // CU_SIMD_VECTOR_AVX512
+
+#if defined(CU_SIMD_VECTOR_AVX2)
+        template<>
+        struct VectorTraits<float> {
+            using Register = __m256;
+            using MaskRegister = __m256;
+            static constexpr int64_t LANES = 8;
+
+            static Register Zero() { return _mm256_setzero_ps(); }
+            static Register Broadcast(float value) { return _mm256_set1_ps(value); }
+            static Register Load(const float* values) { return _mm256_loadu_ps(values); }
+            static void Store(float* values, Register value) { _mm256_storeu_ps(values, value); }
+
+            static Register Add(Register lhs, Register rhs) { return _mm256_add_ps(lhs, rhs); }
+            static Register Sub(Register lhs, Register rhs) { return _mm256_sub_ps(lhs, rhs); }
+            static Register Mul(Register lhs, Register rhs) { return _mm256_mul_ps(lhs, rhs); }
+            static Register Div(Register lhs, Register rhs) { return _mm256_div_ps(lhs, rhs); }
+            static Register Min(Register lhs, Register rhs) { return _mm256_min_ps(lhs, rhs); }
+            static Register Max(Register lhs, Register rhs) { return _mm256_max_ps(lhs, rhs); }
+            static Register MulAdd(Register lhs, Register rhs, Register addend) {
+#if defined(__FMA__)
+                return _mm256_fmadd_ps(lhs, rhs, addend);
+#else
+                return Add(Mul(lhs, rhs), addend);
+#endif // __FMA__
+            }
+            static Register Abs(Register value) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), value); }
+            static Register Sqrt(Register value) { return _mm256_sqrt_ps(value); }
+
+            static MaskRegister Equal(Register lhs, Register rhs) { return _mm256_cmp_ps(lhs, rhs, _CMP_EQ_OQ); }
+            static MaskRegister Less(Register lhs, Register rhs) { return _mm256_cmp_ps(lhs, rhs, _CMP_LT_OQ); }
+            static MaskRegister LessEqual(Register lhs, Register rhs) { return _mm256_cmp_ps(lhs, rhs, _CMP_LE_OQ); }
+            static Register Select(MaskRegister mask, Register lhs, Register rhs) { return _mm256_blendv_ps(rhs, lhs, mask); }
+
+            static MaskRegister MaskAnd(MaskRegister lhs, MaskRegister rhs) { return _mm256_and_ps(lhs, rhs); }
+            static MaskRegister MaskOr(MaskRegister lhs, MaskRegister rhs) { return _mm256_or_ps(lhs, rhs); }
+            static MaskRegister MaskNot(MaskRegister mask) { return _mm256_xor_ps(mask, _mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+            static uint64_t MaskBits(MaskRegister mask) { return uint64_t(_mm256_movemask_ps(mask)); }
+
+            static Register Round(Register value) { return _mm256_round_ps(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+            static __m256i ToInt32(Register value) { return _mm256_cvttps_epi32(value); }
+            static Register FromInt32(__m256i value) { return _mm256_cvtepi32_ps(value); }
+            static __m256i BitsToInt32(Register value) { return _mm256_castps_si256(value); }
+            static Register BitsFromInt32(__m256i value) { return _mm256_castsi256_ps(value); }
+
+            static Register Gather(const float* values, const int32_t* indices) {
+                return _mm256_i32gather_ps(values, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices)), sizeof(float));
+            }
+        };
+
+        template<>
+        struct VectorTraits<double> {
+            using Register = __m256d;
+            using MaskRegister = __m256d;
+            static constexpr int64_t LANES = 4;
+
+            static Register Zero() { return _mm256_setzero_pd(); }
+            static Register Broadcast(double value) { return _mm256_set1_pd(value); }
+            static Register Load(const double* values) { return _mm256_loadu_pd(values); }
+            static void Store(double* values, Register value) { _mm256_storeu_pd(values, value); }
+
+            static Register Add(Register lhs, Register rhs) { return _mm256_add_pd(lhs, rhs); }
+            static Register Sub(Register lhs, Register rhs) { return _mm256_sub_pd(lhs, rhs); }
+            static Register Mul(Register lhs, Register rhs) { return _mm256_mul_pd(lhs, rhs); }
+            static Register Div(Register lhs, Register rhs) { return _mm256_div_pd(lhs, rhs); }
+            static Register Min(Register lhs, Register rhs) { return _mm256_min_pd(lhs, rhs); }
+            static Register Max(Register lhs, Register rhs) { return _mm256_max_pd(lhs, rhs); }
+            static Register MulAdd(Register lhs, Register rhs, Register addend) {
+#if defined(__FMA__)
+                return _mm256_fmadd_pd(lhs, rhs, addend);
+#else
+                return Add(Mul(lhs, rhs), addend);
+#endif // __FMA__
+            }
+            static Register Abs(Register value) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), value); }
+            static Register Sqrt(Register value) { return _mm256_sqrt_pd(value); }
+
+            static MaskRegister Equal(Register lhs, Register rhs) { return _mm256_cmp_pd(lhs, rhs, _CMP_EQ_OQ); }
+            static MaskRegister Less(Register lhs, Register rhs) { return _mm256_cmp_pd(lhs, rhs, _CMP_LT_OQ); }
+            static MaskRegister LessEqual(Register lhs, Register rhs) { return _mm256_cmp_pd(lhs, rhs, _CMP_LE_OQ); }
+            static Register Select(MaskRegister mask, Register lhs, Register rhs) { return _mm256_blendv_pd(rhs, lhs, mask); }
+
+            static MaskRegister MaskAnd(MaskRegister lhs, MaskRegister rhs) { return _mm256_and_pd(lhs, rhs); }
+            static MaskRegister MaskOr(MaskRegister lhs, MaskRegister rhs) { return _mm256_or_pd(lhs, rhs); }
+            static MaskRegister MaskNot(MaskRegister mask) { return _mm256_xor_pd(mask, _mm256_castsi256_pd(_mm256_set1_epi32(-1))); }
+            static uint64_t MaskBits(MaskRegister mask) { return uint64_t(_mm256_movemask_pd(mask)); }
+
+            static Register Round(Register value) { return _mm256_round_pd(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+            // the masked form with the full mask, the plain one uses an undefined register (see AVX512)
+            static Register Gather(const double* values, const int32_t* indices) {
+                return _mm256_mask_i32gather_pd(Zero(), values, _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices)),
+                                                _mm256_castsi256_pd(_mm256_set1_epi32(-1)), sizeof(double));
+            }
+        };
+
+        template<>
+        struct VectorTraits<int32_t> {
+            using Register = __m256i;
+            using MaskRegister = __m256i;
+            static constexpr int64_t LANES = 8;
+
+            static Register Zero() { return _mm256_setzero_si256(); }
+            static Register Broadcast(int32_t value) { return _mm256_set1_epi32(value); }
+            static Register Load(const int32_t* values) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values)); }
+            static void Store(int32_t* values, Register value) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(values), value); }
+
+            static Register Add(Register lhs, Register rhs) { return _mm256_add_epi32(lhs, rhs); }
+            static Register Sub(Register lhs, Register rhs) { return _mm256_sub_epi32(lhs, rhs); }
+            static Register Mul(Register lhs, Register rhs) { return _mm256_mullo_epi32(lhs, rhs); }
+            static Register Min(Register lhs, Register rhs) { return _mm256_min_epi32(lhs, rhs); }
+            static Register Max(Register lhs, Register rhs) { return _mm256_max_epi32(lhs, rhs); }
+            static Register MulAdd(Register lhs, Register rhs, Register addend) { return Add(Mul(lhs, rhs), addend); }
+            static Register Abs(Register value) { return _mm256_abs_epi32(value); }
+
+            static MaskRegister Equal(Register lhs, Register rhs) { return _mm256_cmpeq_epi32(lhs, rhs); }
+            static MaskRegister Less(Register lhs, Register rhs) { return _mm256_cmpgt_epi32(rhs, lhs); }
+            static MaskRegister LessEqual(Register lhs, Register rhs) { return MaskNot(_mm256_cmpgt_epi32(lhs, rhs)); }
+            static Register Select(MaskRegister mask, Register lhs, Register rhs) { return _mm256_blendv_epi8(rhs, lhs, mask); }
+
+            static MaskRegister MaskAnd(MaskRegister lhs, MaskRegister rhs) { return _mm256_and_si256(lhs, rhs); }
+            static MaskRegister MaskOr(MaskRegister lhs, MaskRegister rhs) { return _mm256_or_si256(lhs, rhs); }
+            static MaskRegister MaskNot(MaskRegister mask) { return _mm256_xor_si256(mask, _mm256_set1_epi32(-1)); }
+            static uint64_t MaskBits(MaskRegister mask) { return uint64_t(_mm256_movemask_ps(_mm256_castsi256_ps(mask))); }
+
+            static Register And(Register lhs, Register rhs) { return _mm256_and_si256(lhs, rhs); }
+            static Register Or(Register lhs, Register rhs) { return _mm256_or_si256(lhs, rhs); }
+            static Register Xor(Register lhs, Register rhs) { return _mm256_xor_si256(lhs, rhs); }
+            template<int COUNT>
+            static Register ShiftLeft(Register value) { return _mm256_slli_epi32(value, COUNT); }
+            template<int COUNT>
+            static Register ShiftRight(Register value) { return _mm256_srai_epi32(value, COUNT); }
+
+            static Register Gather(const int32_t* values, const int32_t* indices) {
+                return _mm256_i32gather_epi32(reinterpret_cast<const int*>(values),
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices)), sizeof(int32_t));
+            }
+        };
+#endif // CU_SIMD_VECTOR_AVX2
+
+#if defined(CU_SIMD_VECTOR_SSE4)
+        // SSE doesn't have gather and masked loads, they are emulated by Vector
+        template<>
+        struct VectorTraits<float> {
+            using Register = __m128;
+            using MaskRegister = __m128;
+            static constexpr int64_t LANES = 4;
+
+            static Register Zero() { return _mm_setzero_ps(); }
+            static Register Broadcast(float value) { return _mm_set1_ps(value); }
+            static Register Load(const float* values) { return _mm_loadu_ps(values); }
+            static void Store(float* values, Register value) { _mm_storeu_ps(values, value); }
+
+            static Register Add(Register lhs, Register rhs) { return _mm_add_ps(lhs, rhs); }
+            static Register Sub(Register lhs, Register rhs) { return _mm_sub_ps(lhs, rhs); }
+            static Register Mul(Register lhs, Register rhs) { return _mm_mul_ps(lhs, rhs); }
+            static Register Div(Register lhs, Register rhs) { return _mm_div_ps(lhs, rhs); }
+            static Register Min(Register lhs, Register rhs) { return _mm_min_ps(lhs, rhs); }
+            static Register Max(Register lhs, Register rhs) { return _mm_max_ps(lhs, rhs); }
+            static Register MulAdd(Register lhs, Register rhs, Register addend) { return Add(Mul(lhs, rhs), addend); }
+            static Register Abs(Register value) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), value); }
+            static Register Sqrt(Register value) { return _mm_sqrt_ps(value); }
+
+            static MaskRegister Equal(Register lhs, Register rhs) { return _mm_cmpeq_ps(lhs, rhs); }
+            static MaskRegister Less(Register lhs, Register rhs) { return _mm_cmplt_ps(lhs, rhs); }
+            static MaskRegister LessEqual(Register lhs, Register rhs) { return _mm_cmple_ps(lhs, rhs); }
+            static Register Select(MaskRegister mask, Register lhs, Register rhs) { return _mm_blendv_ps(rhs, lhs, mask); }
+
+            static MaskRegister MaskAnd(MaskRegister lhs, MaskRegister rhs) { return _mm_and_ps(lhs, rhs); }
+            static MaskRegister MaskOr(MaskRegister lhs, MaskRegister rhs) { return _mm_or_ps(lhs, rhs); }
+            static MaskRegister MaskNot(MaskRegister mask) { return _mm_xor_ps(mask, _mm_castsi128_ps(_mm_set1_epi32(-1))); }
+            static uint64_t MaskBits(MaskRegister mask) { return uint64_t(_mm_movemask_ps(mask)); }
+
+            static Register Round(Register value) { return _mm_round_ps(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+            static __m128i ToInt32(Register value) { return _mm_cvttps_epi32(value); }
+            static Register FromInt32(__m128i value) { return _mm_cvtepi32_ps(value); }
+            static __m128i BitsToInt32(Register value) { return _mm_castps_si128(value); }
+            static Register BitsFromInt32(__m128i value) { return _mm_castsi128_ps(value); }
+        };
+
+        template<>
+        struct VectorTraits<double> {
+            using Register = __m128d;
+            using MaskRegister = __m128d;
+            static constexpr int64_t LANES = 2;
+
+            static Register Zero() { return _mm_setzero_pd(); }
+            static Register Broadcast(double value) { return _mm_set1_pd(value); }
+            static Register Load(const double* values) { return _mm_loadu_pd(values); }
+            static void Store(double* values, Register value) { _mm_storeu_pd(values, value); }
+
+            static Register Add(Register lhs, Register rhs) { return _mm_add_pd(lhs, rhs); }
+            static Register Sub(Register lhs, Register rhs) { return _mm_sub_pd(lhs, rhs); }
+            static Register Mul(Register lhs, Register rhs) { return _mm_mul_pd(lhs, rhs); }
+            static Register Div(Register lhs, Register rhs) { return _mm_div_pd(lhs, rhs); }
+            static Register Min(Register lhs, Register rhs) { return _mm_min_pd(lhs, rhs); }
+            static Register Max(Register lhs, Register rhs) { return _mm_max_pd(lhs, rhs); }
+            static Register MulAdd(Register lhs, Register rhs, Register addend) { return Add(Mul(lhs, rhs), addend); }
+            static Register Abs(Register value) { return _mm_andnot_pd(_mm_set1_pd(-0.0), value); }
+            static Register Sqrt(Register value) { return _mm_sqrt_pd(value); }
+
+            static MaskRegister Equal(Register lhs, Register rhs) { return _mm_cmpeq_pd(lhs, rhs); }
+            static MaskRegister Less(Register lhs, Register rhs) { return _mm_cmplt_pd(lhs, rhs); }
+            static MaskRegister LessEqual(Register lhs, Register rhs) { return _mm_cmple_pd(lhs, rhs); }
+            static Register Select(MaskRegister mask, Register lhs, Register rhs) { return _mm_blendv_pd(rhs, lhs, mask); }
+
+            static MaskRegister MaskAnd(MaskRegister lhs, MaskRegister rhs) { return _mm_and_pd(lhs, rhs); }
+            static MaskRegister MaskOr(MaskRegister lhs, MaskRegister rhs) { return _mm_or_pd(lhs, rhs); }
+            static MaskRegister MaskNot(MaskRegister mask) { return _mm_xor_pd(mask, _mm_castsi128_pd(_mm_set1_epi32(-1))); }
+            static uint64_t MaskBits(MaskRegister mask) { return uint64_t(_mm_movemask_pd(mask)); }
+
+            static Register Round(Register value) { return _mm_round_pd(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+        };
+
+        template<>
+        struct VectorTraits<int32_t> {
+            using Register = __m128i;
+            using MaskRegister = __m128i;
+            static constexpr int64_t LANES = 4;
+
+            static Register Zero() { return _mm_setzero_si128(); }
+            static Register Broadcast(int32_t value) { return _mm_set1_epi32(value); }
+            static Register Load(const int32_t* values) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values)); }
+            static void Store(int32_t* values, Register value) { _mm_storeu_si128(reinterpret_cast<__m128i*>(values), value); }
+
+            static Register Add(Register lhs, Register rhs) { return _mm_add_epi32(lhs, rhs); }
+            static Register Sub(Register lhs, Register rhs) { return _mm_sub_epi32(lhs, rhs); }
+            static Register Mul(Register lhs, Register rhs) { return _mm_mullo_epi32(lhs, rhs); }
+            static Register Min(Register lhs, Register rhs) { return _mm_min_epi32(lhs, rhs); }
+            static Register Max(Register lhs, Register rhs) { return _mm_max_epi32(lhs, rhs); }
+            static Register MulAdd(Register lhs, Register rhs, Register addend) { return Add(Mul(lhs, rhs), addend); }
+            static Register Abs(Register value) { return _mm_abs_epi32(value); }
+
+            static MaskRegister Equal(Register lhs, Register rhs) { return _mm_cmpeq_epi32(lhs, rhs); }
+            static MaskRegister Less(Register lhs, Register rhs) { return _mm_cmplt_epi32(lhs, rhs); }
+            static MaskRegister LessEqual(Register lhs, Register rhs) { return MaskNot(_mm_cmpgt_epi32(lhs, rhs)); }
+            static Register Select(MaskRegister mask, Register lhs, Register rhs) { return _mm_blendv_epi8(rhs, lhs, mask); }
+
+            static MaskRegister MaskAnd(MaskRegister lhs, MaskRegister rhs) { return _mm_and_si128(lhs, rhs); }
+            static MaskRegister MaskOr(MaskRegister lhs, MaskRegister rhs) { return _mm_or_si128(lhs, rhs); }
+            static MaskRegister MaskNot(MaskRegister mask) { return _mm_xor_si128(mask, _mm_set1_epi32(-1)); }
+            static uint64_t MaskBits(MaskRegister mask) { return uint64_t(_mm_movemask_ps(_mm_castsi128_ps(mask))); }
+
+            static Register And(Register lhs, Register rhs) { return _mm_and_si128(lhs, rhs); }
+            static Register Or(Register lhs, Register rhs) { return _mm_or_si128(lhs, rhs); }
+            static Register Xor(Register lhs, Register rhs) { return _mm_xor_si128(lhs, rhs); }
+            template<int COUNT>
+            static Register ShiftLeft(Register value) { return _mm_slli_epi32(value, COUNT); }
+            template<int COUNT>
+            static Register ShiftRight(Register value) { return _mm_srai_epi32(value, COUNT); }
+        };
+#endif // CU_SIMD_VECTOR_SSE4
+    } // namespace PrivateImplementation
+
+    // Set of lanes of Vector<T>, the result of comparisons.
+    template<typename T>
+    class Mask {
+    public:
+        using Traits = PrivateImplementation::VectorTraits<T>;
+        using Register = typename Traits::MaskRegister;
+        static constexpr int64_t LANES = Traits::LANES;
+
+        Mask() = default;
+        explicit Mask(Register value) : m_value(value) {}
+
+        Register Native() const { return m_value; }
+        // the lane i is the bit i
+        uint64_t Bits() const { return Traits::MaskBits(m_value); }
+
+    private:
+        Register m_value;
+    };
+
+    // Vector of LANES values of T. The memory may be unaligned.
+    template<typename T>
+    class Vector {
+    public:
+        using Traits = PrivateImplementation::VectorTraits<T>;
+        using Register = typename Traits::Register;
+        using ValueType = T;
+        static constexpr int64_t LANES = Traits::LANES;
+
+        Vector() = default;
+        explicit Vector(Register value) : m_value(value) {}
+
+        static Vector Zero() { return Vector(Traits::Zero()); }
+        static Vector Broadcast(T value) { return Vector(Traits::Broadcast(value)); }
+        static Vector Load(const T* values) { return Vector(Traits::Load(values)); }
+
+        // { start, start + 1, ..., start + LANES - 1 }
+        static Vector Iota(T start) {
+            alignas(64) T values[LANES];
+            for (int64_t lane = 0; lane < LANES; lane++) {
+                values[lane] = T(start + T(lane));
+            }
+            return Load(values);
+        }
+
+        // loads min(count, LANES) values, the other lanes are zero, the memory after them isn't read
+        static Vector LoadPartial(const T* values, int64_t count) {
+            if (count >= LANES)
+                return Load(values);
+            if constexpr (requires { Traits::LoadPartial(values, count); }) {
+                return Vector(Traits::LoadPartial(values, count));
+            } else {
+                alignas(64) T buffer[LANES] = {};
+                std::memcpy(buffer, values, size_t(count) * sizeof(T));
+                return Load(buffer);
+            }
+        }
+
+        // { values[indices[0]], ..., values[indices[LANES - 1]] }
+        static Vector Gather(const T* values, const int32_t* indices) {
+            if constexpr (requires { Traits::Gather(values, indices); }) {
+                return Vector(Traits::Gather(values, indices));
+            } else {
+                alignas(64) T buffer[LANES];
+                for (int64_t lane = 0; lane < LANES; lane++) {
+                    buffer[lane] = values[indices[lane]];
+                }
+                return Load(buffer);
+            }
+        }
+
+        void Store(T* values) const { Traits::Store(values, m_value); }
+
+        // stores min(count, LANES) values, the memory after them isn't written
+        void StorePartial(T* values, int64_t count) const {
+            if (count >= LANES) {
+                Store(values);
+                return;
+            }
+            if constexpr (requires { Traits::StorePartial(values, m_value, count); }) {
+                Traits::StorePartial(values, m_value, count);
+            } else {
+                alignas(64) T buffer[LANES];
+                Store(buffer);
+                std::memcpy(values, buffer, size_t(count) * sizeof(T));
+            }
+        }
+
+        Register Native() const { return m_value; }
+
+        Vector& operator+=(const Vector& other) { return *this = *this + other; }
+        Vector& operator-=(const Vector& other) { return *this = *this - other; }
+        Vector& operator*=(const Vector& other) { return *this = *this * other; }
+        Vector& operator/=(const Vector& other) { return *this = *this / other; }
+
+    private:
+        Register m_value;
+    };
+
+    // arithmetic
+
+    template<typename T>
+    inline Vector<T> operator+(const Vector<T>& lhs, const Vector<T>& rhs) {
+        return Vector<T>(Vector<T>::Traits::Add(lhs.Native(), rhs.Native()));
+    }
+
+    template<typename T>
+    inline Vector<T> operator-(const Vector<T>& lhs, const Vector<T>& rhs) {
+        return Vector<T>(Vector<T>::Traits::Sub(lhs.Native(), rhs.Native()));
+    }
+
+    template<typename T>
+    inline Vector<T> operator*(const Vector<T>& lhs, const Vector<T>& rhs) {
+        return Vector<T>(Vector<T>::Traits::Mul(lhs.Native(), rhs.Native()));
+    }
+
+    // floating point only
+    template<typename T>
+    inline Vector<T> operator/(const Vector<T>& lhs, const Vector<T>& rhs) {
+        return Vector<T>(Vector<T>::Traits::Div(lhs.Native(), rhs.Native()));
+    }
+
+    template<typename T>
+    inline Vector<T> operator-(const Vector<T>& value) {
+        return Vector<T>::Zero() - value;
+    }
+
+    // if any argument is NaN, the second one is returned
+    template<typename T>
+    inline Vector<T> min(const Vector<T>& lhs, const Vector<T>& rhs) {
+        return Vector<T>(Vector<T>::Traits::Min(lhs.Native(), rhs.Native()));
+    }
+
+    template<typename T>
+    inline Vector<T> max(const Vector<T>& lhs, const Vector<T>& rhs) {
+        return Vector<T>(Vector<T>::Traits::Max(lhs.Native(), rhs.Native()));
+    }
+
+    // lhs * rhs + addend, it's fused if the compile unit supports FMA,
+    // so the result may differ from the separate operations in the last bit
+    template<typename T>
+    inline Vector<T> mul_add(const Vector<T>& lhs, const Vector<T>& rhs, const Vector<T>& addend) {
+        return Vector<T>(Vector<T>::Traits::MulAdd(lhs.Native(), rhs.Native(), addend.Native()));
+    }
+
+    template<typename T>
+    inline Vector<T> abs(const Vector<T>& value) {
+        return Vector<T>(Vector<T>::Traits::Abs(value.Native()));
+    }
+
+    // floating point only
+    template<typename T>
+    inline Vector<T> sqrt(const Vector<T>& value) {
+        return Vector<T>(Vector<T>::Traits::Sqrt(value.Native()));
+    }
+
+    // floating point only, the nearest integer value, ties to even
+    template<typename T>
+    inline Vector<T> round(const Vector<T>& value) {
+        return Vector<T>(Vector<T>::Traits::Round(value.Native()));
+    }
+
+    // bitwise operations and shifts, integer only
+
+    template<typename T>
+    inline Vector<T> operator&(const Vector<T>& lhs, const Vector<T>& rhs) {
+        return Vector<T>(Vector<T>::Traits::And(lhs.Native(), rhs.Native()));
+    }
+
+    template<typename T>
+    inline Vector<T> operator|(const Vector<T>& lhs, const Vector<T>& rhs) {
+        return Vector<T>(Vector<T>::Traits::Or(lhs.Native(), rhs.Native()));
+    }
+
+    template<typename T>
+    inline Vector<T> operator^(const Vector<T>& lhs, const Vector<T>& rhs) {
+        return Vector<T>(Vector<T>::Traits::Xor(lhs.Native(), rhs.Native()));
+    }
+
+    template<int COUNT, typename T>
+    inline Vector<T> shift_left(const Vector<T>& value) {
+        return Vector<T>(Vector<T>::Traits::template ShiftLeft<COUNT>(value.Native()));
+    }
+
+    // arithmetic shift, the sign bit is kept
+    template<int COUNT, typename T>
+    inline Vector<T> shift_right(const Vector<T>& value) {
+        return Vector<T>(Vector<T>::Traits::template ShiftRight<COUNT>(value.Native()));
+    }
+
+    // conversions between float and int32_t vectors, they have the same number of lanes
+    static_assert(Vector<float>::LANES == Vector<int32_t>::LANES);
+
+    // the values are truncated, the result is undefined if they are out of the int32_t range
+    inline Vector<int32_t> convert_to_int32(const Vector<float>& value) {
+        return Vector<int32_t>(Vector<float>::Traits::ToInt32(value.Native()));
+    }
+
+    inline Vector<float> convert_to_float(const Vector<int32_t>& value) {
+        return Vector<float>(Vector<float>::Traits::FromInt32(value.Native()));
+    }
+
+    inline Vector<int32_t> bit_cast_to_int32(const Vector<float>& value) {
+        return Vector<int32_t>(Vector<float>::Traits::BitsToInt32(value.Native()));
+    }
+
+    inline Vector<float> bit_cast_to_float(const Vector<int32_t>& value) {
+        return Vector<float>(Vector<float>::Traits::BitsFromInt32(value.Native()));
+    }
+
+    // comparisons, they are false for NaN except operator!=
+
+    template<typename T>
+    inline Mask<T> operator==(const Vector<T>& lhs, const Vector<T>& rhs) {
+        return Mask<T>(Vector<T>::Traits::Equal(lhs.Native(), rhs.Native()));
+    }
+
+    template<typename T>
+    inline Mask<T> operator!=(const Vector<T>& lhs, const Vector<T>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<typename T>
+    inline Mask<T> operator<(const Vector<T>& lhs, const Vector<T>& rhs) {
+        return Mask<T>(Vector<T>::Traits::Less(lhs.Native(), rhs.Native()));
+    }
+
+    template<typename T>
+    inline Mask<T> operator<=(const Vector<T>& lhs, const Vector<T>& rhs) {
+        return Mask<T>(Vector<T>::Traits::LessEqual(lhs.Native(), rhs.Native()));
+    }
+
+    template<typename T>
+    inline Mask<T> operator>(const Vector<T>& lhs, const Vector<T>& rhs) {
+        return rhs < lhs;
+    }
+
+    template<typename T>
+    inline Mask<T> operator>=(const Vector<T>& lhs, const Vector<T>& rhs) {
+        return rhs <= lhs;
+    }
+
+    // masks
+
+    template<typename T>
+    inline Mask<T> operator&(const Mask<T>& lhs, const Mask<T>& rhs) {
+        return Mask<T>(Mask<T>::Traits::MaskAnd(lhs.Native(), rhs.Native()));
+    }
+
+    template<typename T>
+    inline Mask<T> operator|(const Mask<T>& lhs, const Mask<T>& rhs) {
+        return Mask<T>(Mask<T>::Traits::MaskOr(lhs.Native(), rhs.Native()));
+    }
+
+    template<typename T>
+    inline Mask<T> operator!(const Mask<T>& mask) {
+        return Mask<T>(Mask<T>::Traits::MaskNot(mask.Native()));
+    }
+
+    // mask ? lhs : rhs for each lane
+    template<typename T>
+    inline Vector<T> select(const Mask<T>& mask, const Vector<T>& lhs, const Vector<T>& rhs) {
+        return Vector<T>(Vector<T>::Traits::Select(mask.Native(), lhs.Native(), rhs.Native()));
+    }
+
+    template<typename T>
+    inline bool any(const Mask<T>& mask) {
+        return mask.Bits() != 0;
+    }
+
+    template<typename T>
+    inline bool all(const Mask<T>& mask) {
+        return mask.Bits() == (uint64_t(1) << Mask<T>::LANES) - 1;
+    }
+
+    template<typename T>
+    inline int64_t count_true(const Mask<T>& mask) {
+        return std::popcount(mask.Bits());
+    }
+
+    // index of the first true lane, -1 if there is no one
+    template<typename T>
+    inline int64_t find_first(const Mask<T>& mask) {
+        const auto bits = mask.Bits();
+        return bits ? std::countr_zero(bits) : -1;
+    }
+
+    // reductions, the lanes are combined pairwise, so the result of reduce_add
+    // may differ from the sequential sum for floating point values
+
+    namespace PrivateImplementation {
+        template<typename T, typename Operation>
+        inline T reduce(const Vector<T>& value, Operation operation) {
+            alignas(64) T lanes[Vector<T>::LANES];
+            value.Store(lanes);
+            for (int64_t width = Vector<T>::LANES / 2; width > 0; width /= 2) {
+                for (int64_t lane = 0; lane < width; lane++) {
+                    lanes[lane] = operation(lanes[lane], lanes[lane + width]);
+                }
+            }
+            return lanes[0];
+        }
+    } // namespace PrivateImplementation
+
+    template<typename T>
+    inline T reduce_add(const Vector<T>& value) {
+        return PrivateImplementation::reduce(value, [](T lhs, T rhs) { return T(lhs + rhs); });
+    }
+
+    template<typename T>
+    inline T reduce_min(const Vector<T>& value) {
+        return PrivateImplementation::reduce(value, [](T lhs, T rhs) { return rhs < lhs ? rhs : lhs; });
+    }
+
+    template<typename T>
+    inline T reduce_max(const Vector<T>& value) {
+        return PrivateImplementation::reduce(value, [](T lhs, T rhs) { return rhs > lhs ? rhs : lhs; });
+    }
+} // inline namespace CU_SIMD(unit)
+} // namespace CU::Simd
@@ -27,6 +27,8 @@
 //      CU_PATCH_CONTROL_DATA,
 //      CU_ENABLE_DEBUG_PERFORMANCE_TEST,
 //      CU_PRINT_PERFORMANCE_TEST_RESULT
+//      CU_PERFORMANCE_TEST_PERCENTILE (compare implementations by the given percentile instead of the average duration,
+//                                      requires profiler histograms, see CU::ProfilerConfiguration)
 // macros
 //      CU_CONFORMANCE_TEST_CONFIGURABLE(is_weak, name, test_data_path, test_file, control_file, test_functions, additional_args)
 //      CU_CONFORMANCE_TEST(name, test_data_path, test_file, control_file, test_functions, additional_args)
@@ -83,7 +85,7 @@ namespace CU {
             TestFunctionsList<Unit, AdditionalArgs...> test_functions,
             TestFunctionsNames test_functions_names,
             AdditionalArgs... additional_args) {
-        auto input_data = CU::load_data_from_file<Unit>(test_data_path);
+        const auto input_data = CU::map_data_from_file<Unit>(test_data_path);
         ASSERT_FALSE(input_data.empty()) << "Failed to load test data";
 
         auto output_data = CU::load_data_from_file<Unit>(control_data_path);
@@ -135,6 +137,15 @@ namespace CU {
 
     static constexpr double WORSE_ACCELERATION_RATIO = 0.5;
 
+    // duration used to compare implementations in performance tests
+    static inline int64_t get_performance_test_duration_ns(const TimerResult& result) {
+#if defined(CU_PERFORMANCE_TEST_PERCENTILE)
+        if (result.HasPercentiles())
+            return result.GetPercentileNS(CU_PERFORMANCE_TEST_PERCENTILE);
+#endif
+        return result.GetAvgNS();
+    }
+
     template <size_t repeats_count = 10u,
               size_t result_size_scale_num = 1u,
               size_t result_size_scale_den = 1u,
@@ -149,7 +160,8 @@ namespace CU {
         ASSERT_EQ(test_functions.size(), test_functions_names.size()) << 
             "The number of functions and their names must match";
 
-        auto input_data = CU::load_data_from_file<Unit>(test_data_path);
+        // read ahead, so the first measured function doesn't pay for page faults
+        const auto input_data = CU::map_data_from_file<Unit>(test_data_path, CU::MappedFileAccess::WILL_NEED);
         ASSERT_FALSE(input_data.empty()) << "Failed to load test data";
 
         size_t result_size = input_data.size() * result_size_scale_num / result_size_scale_den;
@@ -172,32 +184,39 @@ namespace CU {
 
         ASSERT_NE(call_functions_count, 0) << "no functions were called";
 
-        auto results = CU_PROFILE_GET_RESULTS(test_functions_names);
-        EXPECT_EQ(results.size(), call_functions_count) << "Profiler implementation error";
+        // results are looked up in place by the full key of the timer ("KEY: location")
+        const auto results = CU::ProfilerAggregator::GetResultsSnapshot();
+        size_t found_results_count = 0;
         int64_t prev_avg_ns = 0;
 
         for (size_t index = 0; index < test_functions.size(); index++) {
-            if (results.end() == results.find(test_functions_names[index]))
+            const auto* result = results.FindFirst(test_functions_names[index] + ": ");
+            if (!result)
                 continue;
+            found_results_count++;
 
             const auto& func_name = test_functions_names[index];
-            const auto current_avg_ns = results[func_name].GetAvgNS();
+            const auto current_avg_ns = get_performance_test_duration_ns(*result);
             double acr_ratio = double(prev_avg_ns) / double(current_avg_ns);
 #if defined(CU_PRINT_PERFORMANCE_TEST_RESULT)
             std::cout << func_name << ":" << std::endl;
-            std::cout << results[func_name];
+            std::cout << *result;
             std::cout << "\tacceleration ratio: " << acr_ratio << std::endl << std::endl;
 #endif
 
             if (prev_avg_ns && current_avg_ns >= prev_avg_ns) {
-                ASSERT_FALSE(strong_less) << "Subsequent implementation is not faster than the previous one";
+                ASSERT_FALSE(strong_less) << "Subsequent implementation is not faster than the previous one" <<
+                    std::endl << func_name << ":" << std::endl << *result;
 
                 // check if results almost equal
-                EXPECT_LE(WORSE_ACCELERATION_RATIO, acr_ratio) << "Subsequent implementation is significantly slower than the previous one";
+                EXPECT_LE(WORSE_ACCELERATION_RATIO, acr_ratio) << "Subsequent implementation is significantly slower than the previous one" <<
+                    std::endl << func_name << ":" << std::endl << *result;
             }
 
             prev_avg_ns = current_avg_ns;
         }
+
+        EXPECT_EQ(found_results_count, call_functions_count) << "Profiler implementation error";
     }
 }
 
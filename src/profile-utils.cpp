@@ -4,11 +4,598 @@
 // License: MIT
 
 #include <cu/profile-utils.hpp>
+#include <cu/cpu-utils.hpp>
 
-#if ENABLE_CU_PROFILE
+#include <fstream>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif // __linux__
+
+#if defined(ENABLE_CU_PROFILE)
 namespace CU {
+    namespace {
+        void write_json_string(std::ostream& os, std::string_view str) {
+            os << '"';
+            for (char c : str) {
+                if ('"' == c || '\\' == c)
+                    os << '\\' << c;
+                else if (static_cast<unsigned char>(c) < 0x20)
+                    os << "\\u00" << "0123456789abcdef"[(c >> 4) & 0xf] << "0123456789abcdef"[c & 0xf];
+                else
+                    os << c;
+            }
+            os << '"';
+        }
+
+        void write_csv_string(std::ostream& os, std::string_view str) {
+            os << '"';
+            for (char c : str) {
+                if ('"' == c)
+                    os << '"';
+                os << c;
+            }
+            os << '"';
+        }
+    }
+
+    std::atomic<ProfilerClock::ClockMode> ProfilerClock::m_mode = ProfilerClock::ClockMode::STEADY_CLOCK;
+    std::atomic<double> ProfilerClock::m_ns_per_tick = 1.0;
+
+    bool ProfilerClock::Setup(ProfilerClockSource source) {
+        if (ProfilerClockSource::STEADY_CLOCK == source || !is_invariant_tsc_supported()) {
+            m_mode.store(ClockMode::STEADY_CLOCK, std::memory_order_release);
+            return ProfilerClockSource::TSC != source;
+        }
+
+#if defined(CU_ARCH_X86_64)
+        // calibration of TSC frequency by steady clock
+        constexpr auto calibration_duration = std::chrono::milliseconds(20);
+
+        const auto steady_start = std::chrono::steady_clock::now();
+        const auto tsc_start = __rdtsc();
+        std::this_thread::sleep_for(calibration_duration);
+        const auto steady_end = std::chrono::steady_clock::now();
+        const auto tsc_end = __rdtsc();
+
+        const auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(steady_end - steady_start).count();
+        m_ns_per_tick.store(double(elapsed_ns) / double(tsc_end - tsc_start), std::memory_order_relaxed);
+        m_mode.store(is_rdtscp_supported() ? ClockMode::RDTSCP : ClockMode::RDTSC, std::memory_order_release);
+#endif // CU_ARCH_X86_64
+        return true;
+    }
+
+    std::atomic<bool> ProfilerAggregator::m_collect_histograms = false;
+    std::atomic<bool> ProfilerAggregator::m_collect_call_tree = false;
+    std::atomic<size_t> ProfilerAggregator::m_trace_buffer_capacity = 0;
+    std::atomic<bool> ProfilerAggregator::m_collect_hardware_counters = false;
+
     std::mutex ProfilerAggregator::m_timer_results_lock;
-    std::unordered_map<std::string, TimerResult> ProfilerAggregator::m_timer_results;
+    std::unordered_map<std::string, TimerId> ProfilerAggregator::m_timers_ids;
+    std::vector<std::string> ProfilerAggregator::m_timers_names;
+    std::vector<TimerResult> ProfilerAggregator::m_timer_results;
+    std::vector<TimerResult> ProfilerAggregator::m_interval_results;
+    CallTree ProfilerAggregator::m_call_tree;
+    std::vector<ProfilerAggregator::ThreadTimersResults*> ProfilerAggregator::m_threads_results;
+    ProfilerAggregator::ResultsSnapshot::SortedTimers ProfilerAggregator::m_sorted_timers;
+    std::deque<std::pair<uint32_t, TraceEvent>> ProfilerAggregator::m_retired_trace_events;
+    uint32_t ProfilerAggregator::m_threads_count = 0;
+
+    ProfilerAggregator::ProfilerAggregator(const ProfilerConfiguration& configuration) :
+        m_configuration(configuration),
+        m_sinks(configuration.m_sinks) {
+        m_collect_histograms = configuration.m_collect_histograms;
+        m_collect_call_tree = configuration.m_collect_call_tree;
+        m_trace_buffer_capacity = configuration.m_trace_buffer_capacity;
+        m_collect_hardware_counters = configuration.m_collect_hardware_counters;
+        // the steady clock is used if TSC isn't invariant, ProfilerClock::IsTscUsed tells the selected clock
+        ProfilerClock::Setup(configuration.m_clock_source);
+
+        if (m_sinks.empty())
+            m_sinks.push_back(std::make_shared<StreamProfilerSink>(std::cout));
+
+        m_start = std::chrono::steady_clock::now();
+        m_interval_start = m_start;
+        if (m_configuration.m_report_interval.count() > 0)
+            m_reporter = std::thread(&ProfilerAggregator::RunReporter, this);
+    }
+
+    ProfilerAggregator::~ProfilerAggregator() {
+        if (m_reporter.joinable()) {
+            {
+                std::scoped_lock _(m_reporter_lock);
+                m_is_reporter_stopped = true;
+            }
+            m_reporter_stop_condition.notify_one();
+            m_reporter.join();
+
+            WriteIntervalReport();
+        }
+
+        const auto results = GetCurrentResults();
+        const auto total_duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - m_start).count();
+        for (const auto& sink : m_sinks) {
+            sink->Write(ProfilerReportKind::TOTAL, total_duration_ns, results);
+        }
+
+        if (!m_configuration.m_trace_file.empty())
+            WriteTrace(m_configuration.m_trace_file);
+    }
+
+    void ProfilerAggregator::WriteIntervalReport() {
+        TimersResults results;
+        {
+            std::scoped_lock _(m_timer_results_lock);
+
+            for (auto* thread_results : m_threads_results) {
+                thread_results->FlushTo(m_interval_results);
+            }
+
+            if (m_timer_results.size() < m_interval_results.size())
+                m_timer_results.resize(m_interval_results.size());
+            for (TimerId timer_id = 0; timer_id < m_interval_results.size(); timer_id++) {
+                auto& interval_result = m_interval_results[timer_id];
+                if (!interval_result.m_activations_count)
+                    continue;
+
+                results[m_timers_names[timer_id]] = interval_result;
+                m_timer_results[timer_id].Merge(interval_result);
+                interval_result.Reset();
+            }
+        }
+
+        const auto interval_end = std::chrono::steady_clock::now();
+        const auto interval_duration_ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(interval_end - m_interval_start).count();
+        m_interval_start = interval_end;
+
+        for (const auto& sink : m_sinks) {
+            sink->Write(ProfilerReportKind::INTERVAL, interval_duration_ns, results);
+        }
+    }
+
+    void ProfilerAggregator::RunReporter() {
+        std::unique_lock lock(m_reporter_lock);
+        while (!m_reporter_stop_condition.wait_for(lock, m_configuration.m_report_interval,
+                                                   [this] { return m_is_reporter_stopped; })) {
+            lock.unlock();
+            WriteIntervalReport();
+            lock.lock();
+        }
+    }
+
+    TimerId ProfilerAggregator::RegisterTimer(std::string timer_name) {
+        std::scoped_lock _(m_timer_results_lock);
+
+        auto [it, is_inserted] = m_timers_ids.try_emplace(timer_name, TimerId(m_timers_names.size()));
+        if (is_inserted) {
+            m_timers_names.push_back(std::move(timer_name));
+
+            // keys of the map aren't moved on rehashing
+            const std::pair<std::string_view, TimerId> sorted_timer{ it->first, it->second };
+            m_sorted_timers.insert(
+                std::upper_bound(m_sorted_timers.begin(), m_sorted_timers.end(), sorted_timer),
+                sorted_timer);
+        }
+        return it->second;
+    }
+
+    ProfilerAggregator::ResultsSnapshot::ResultsSnapshot(const std::vector<std::string_view>& prefixes) {
+        SortedTimers timers;
+        std::vector<TimerId> timers_ids;
+        std::vector<TimerResult> results;
+        {
+            std::scoped_lock _(m_timer_results_lock);
+
+            if (prefixes.empty()) {
+                timers = m_sorted_timers;
+            }
+            else {
+                // prefixes may overlap, so the matching timers are marked first
+                std::vector<bool> is_matched(m_sorted_timers.size());
+                for (auto prefix : prefixes) {
+                    auto it = std::lower_bound(m_sorted_timers.begin(), m_sorted_timers.end(), prefix,
+                        [](const SortedTimers::value_type& timer, std::string_view key) { return timer.first < key; });
+                    for (; m_sorted_timers.end() != it && it->first.starts_with(prefix); ++it) {
+                        is_matched[size_t(it - m_sorted_timers.begin())] = true;
+                    }
+                }
+
+                for (size_t index = 0; index < m_sorted_timers.size(); index++) {
+                    if (is_matched[index])
+                        timers.push_back(m_sorted_timers[index]);
+                }
+            }
+
+            timers_ids.reserve(timers.size());
+            for (const auto& timer : timers) {
+                timers_ids.push_back(timer.second);
+            }
+            results.resize(timers.size());
+
+            // results of already finished threads and flushed results
+            for (const auto* finished_results : { &m_timer_results, &m_interval_results }) {
+                for (size_t index = 0; index < timers_ids.size(); index++) {
+                    if (timers_ids[index] < finished_results->size())
+                        results[index].Merge((*finished_results)[timers_ids[index]]);
+                }
+            }
+            for (const auto* thread_results : m_threads_results) {
+                thread_results->MergeTo(timers_ids, results);
+            }
+        }
+
+        for (size_t index = 0; index < timers.size(); index++) {
+            if (results[index].m_activations_count)
+                m_results.emplace_back(timers[index].first, std::move(results[index]));
+        }
+    }
+
+    ProfilerAggregator::TimersResults ProfilerAggregator::GetCurrentResults() {
+        TimersResults named_results;
+        GetResultsSnapshot().Visit("", [&named_results](std::string_view timer_name, const TimerResult& result) {
+            named_results.emplace(timer_name, result);
+            });
+        return named_results;
+    }
+
+    std::string ProfilerAggregator::GetTimerName(TimerId timer_id) {
+        std::scoped_lock _(m_timer_results_lock);
+        return m_timers_names.at(timer_id);
+    }
+
+    CallTree ProfilerAggregator::GetCallTree() {
+        std::scoped_lock _(m_timer_results_lock);
+
+        // call tree of already finished threads
+        CallTree call_tree = m_call_tree;
+        for (const auto* thread_results : m_threads_results) {
+            thread_results->MergeTo(call_tree);
+        }
+        return call_tree;
+    }
+
+    void ProfilerAggregator::WriteCollapsedStacks(std::ostream& os) {
+        const auto call_tree = GetCallTree();
+
+        std::scoped_lock _(m_timer_results_lock);
+
+        // ';' separates frames in the collapsed stacks format
+        auto get_frame_name = [](std::string name) {
+            std::replace(name.begin(), name.end(), ';', ':');
+            return name;
+            };
+
+        std::vector<std::pair<CallTree::NodeIndex, std::string>> nodes_to_write;
+        for (auto child : call_tree.GetNode(CallTree::ROOT_NODE).m_children) {
+            nodes_to_write.emplace_back(child, get_frame_name(m_timers_names[call_tree.GetNode(child).m_timer_id]));
+        }
+
+        while (!nodes_to_write.empty()) {
+            auto [node_index, stack] = std::move(nodes_to_write.back());
+            nodes_to_write.pop_back();
+
+            const auto& node = call_tree.GetNode(node_index);
+            if (node.GetExclusiveNS() > 0)
+                os << stack << " " << node.GetExclusiveNS() << "\n";
+
+            for (auto child : node.m_children) {
+                nodes_to_write.emplace_back(child,
+                    stack + ";" + get_frame_name(m_timers_names[call_tree.GetNode(child).m_timer_id]));
+            }
+        }
+        os.flush();
+    }
+
+    void ProfilerAggregator::WriteTrace(std::ostream& os) {
+        std::vector<std::pair<uint32_t, std::vector<TraceEvent>>> threads_events;
+        std::vector<std::string> timers_names;
+        {
+            std::scoped_lock _(m_timer_results_lock);
+
+            for (const auto* thread_results : m_threads_results) {
+                threads_events.emplace_back(thread_results->GetThreadIndex(), std::vector<TraceEvent>{});
+                thread_results->CopyTo(threads_events.back().second);
+            }
+            // events of already finished threads, they are released
+            std::map<uint32_t, std::vector<TraceEvent>> retired_events;
+            for (const auto& [thread_index, event] : m_retired_trace_events) {
+                retired_events[thread_index].push_back(event);
+            }
+            m_retired_trace_events.clear();
+            for (auto& [thread_index, events] : retired_events) {
+                threads_events.emplace_back(thread_index, std::move(events));
+            }
+            timers_names = m_timers_names;
+        }
+
+        // timestamps are written in microseconds relative to the earliest event
+        int64_t origin_ticks = std::numeric_limits<int64_t>::max();
+        for (const auto& [thread_index, events] : threads_events) {
+            for (const auto& event : events)
+                origin_ticks = std::min(origin_ticks, event.m_start_ticks);
+        }
+
+        auto write_us = [&os](int64_t ns) {
+            os << ns / 1000 << '.' << char('0' + ns % 1000 / 100) << char('0' + ns % 100 / 10) << char('0' + ns % 10);
+            };
+
+        os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool is_first_event = true;
+        for (const auto& [thread_index, events] : threads_events) {
+            os << (is_first_event ? "\n" : ",\n");
+            is_first_event = false;
+            os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread_index
+               << ",\"args\":{\"name\":\"thread " << thread_index << "\"}}";
+
+            for (const auto& event : events) {
+                os << ",\n{\"name\":";
+                write_json_string(os, timers_names[event.m_timer_id]);
+                os << ",\"cat\":\"cu\",\"ph\":\"X\",\"ts\":";
+                write_us(ProfilerClock::ToNanoseconds(event.m_start_ticks - origin_ticks));
+                os << ",\"dur\":";
+                write_us(ProfilerClock::ToNanoseconds(std::max(event.m_stop_ticks - event.m_start_ticks, int64_t(0))));
+                os << ",\"pid\":0,\"tid\":" << thread_index << "}";
+            }
+        }
+        os << "\n]}\n";
+        os.flush();
+    }
+
+    bool ProfilerAggregator::WriteTrace(const std::filesystem::path& file_name) {
+        std::ofstream file(file_name);
+        if (!file.is_open())
+            return false;
+
+        WriteTrace(file);
+        return file.good();
+    }
+
+    void TraceBuffer::CopyTo(std::vector<TraceEvent>& events) const {
+        const uint64_t capacity = m_slots.size();
+        const auto written_count = m_written_count.load(std::memory_order_acquire);
+        const auto first_index = written_count > capacity ? written_count - capacity : 0;
+
+        for (auto index = first_index; index < written_count; index++) {
+            const auto& slot = m_slots[index % capacity];
+
+            const auto sequence = slot.m_sequence.load(std::memory_order_acquire);
+            const TraceEvent event{
+                slot.m_timer_id.load(std::memory_order_relaxed),
+                slot.m_start_ticks.load(std::memory_order_relaxed),
+                slot.m_stop_ticks.load(std::memory_order_relaxed) };
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            // the slot is skipped if the owner thread has overwritten it during the copy
+            if (2 * index + 2 == sequence && sequence == slot.m_sequence.load(std::memory_order_relaxed))
+                events.push_back(event);
+        }
+    }
+
+    HardwareCountersReader::HardwareCountersReader() {
+        m_descriptors.fill(-1);
+
+#if defined(__linux__)
+        constexpr std::array<uint64_t, COUNTERS_COUNT> counters = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES };
+
+        for (size_t i = 0; i < COUNTERS_COUNT; i++) {
+            perf_event_attr attributes{};
+            attributes.size           = sizeof(attributes);
+            attributes.type           = PERF_TYPE_HARDWARE;
+            attributes.config         = counters[i];
+            attributes.read_format    = PERF_FORMAT_GROUP;
+            attributes.disabled       = i == 0 ? 1 : 0;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv     = 1;
+
+            // the first counter is the leader of the group, so all counters are read at once
+            m_descriptors[i] = int(syscall(SYS_perf_event_open, &attributes, 0, -1, m_descriptors[0], 0));
+            // the reader stays unavailable, timers collect only durations
+            if (m_descriptors[i] < 0)
+                return;
+        }
+
+        ioctl(m_descriptors[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(m_descriptors[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        m_is_available = true;
+#endif // __linux__
+    }
+
+    HardwareCountersReader::~HardwareCountersReader() {
+#if defined(__linux__)
+        for (int descriptor : m_descriptors) {
+            if (descriptor >= 0)
+                close(descriptor);
+        }
+#endif // __linux__
+    }
+
+    bool HardwareCountersReader::Read(HardwareCounters& counters) const {
+        if (!m_is_available)
+            return false;
+
+#if defined(__linux__)
+        // PERF_FORMAT_GROUP layout: number of counters, then values in the order of opening
+        std::array<uint64_t, COUNTERS_COUNT + 1> values{};
+        const auto values_size = ssize_t(sizeof(values));
+        if (read(m_descriptors[0], values.data(), sizeof(values)) != values_size)
+            return false;
+
+        counters.m_cycles        = int64_t(values[1]);
+        counters.m_instructions  = int64_t(values[2]);
+        counters.m_cache_misses  = int64_t(values[3]);
+        counters.m_branch_misses = int64_t(values[4]);
+        return true;
+#else
+        (void)counters;
+        return false;
+#endif // __linux__
+    }
+
+    void CallTree::MergeTo(CallTree& other) const {
+        // parents are always added before their children
+        std::vector<NodeIndex> other_nodes(m_nodes.size(), ROOT_NODE);
+        for (NodeIndex node_index = 1; node_index < m_nodes.size(); node_index++) {
+            const auto& node = m_nodes[node_index];
+            const auto other_parent = other_nodes[node.m_parent];
+
+            auto other_node = other.FindChild(other_parent, node.m_timer_id);
+            if (INVALID_NODE == other_node)
+                other_node = other.AddChild(other_parent, node.m_timer_id);
+
+            other.m_nodes[other_node].m_result.Merge(node.m_result);
+            other.m_nodes[other_node].m_children_duration_ns += node.m_children_duration_ns;
+            other_nodes[node_index] = other_node;
+        }
+    }
+
+    ProfilerAggregator::ThreadTimersResults::ThreadTimersResults() {
+        std::scoped_lock _(m_timer_results_lock);
+        m_thread_index = m_threads_count++;
+        m_threads_results.push_back(this);
+    }
+
+    ProfilerAggregator::ThreadTimersResults::~ThreadTimersResults() {
+        std::scoped_lock _(m_timer_results_lock);
+        MergeTo(m_interval_results);
+        MergeTo(m_call_tree);
+        // the buffer is merged into the common ring of finished threads, so the memory doesn't grow with threads
+        if (m_trace_buffer) {
+            std::vector<TraceEvent> events;
+            m_trace_buffer->CopyTo(events);
+            for (const auto& event : events) {
+                m_retired_trace_events.emplace_back(m_thread_index, event);
+            }
+
+            const auto capacity = m_trace_buffer_capacity.load(std::memory_order_relaxed);
+            while (m_retired_trace_events.size() > capacity) {
+                m_retired_trace_events.pop_front();
+            }
+        }
+        std::erase(m_threads_results, this);
+    }
+
+    void ProfilerAggregator::ThreadTimersResults::MergeTo(std::vector<TimerResult>& results) const {
+        std::scoped_lock _(m_results_lock);
+        if (results.size() < std::max(m_results.size(), m_untimed_counts.size()))
+            results.resize(std::max(m_results.size(), m_untimed_counts.size()));
+        for (TimerId timer_id = 0; timer_id < m_results.size(); timer_id++) {
+            results[timer_id].Merge(m_results[timer_id]);
+        }
+        for (TimerId timer_id = 0; timer_id < m_untimed_counts.size(); timer_id++) {
+            const auto untimed_count = std::atomic_ref<const int64_t>(m_untimed_counts[timer_id]).load(std::memory_order_relaxed);
+            const auto flushed_count = timer_id < m_flushed_untimed_counts.size() ? m_flushed_untimed_counts[timer_id] : 0;
+            if (untimed_count > flushed_count)
+                results[timer_id].StoreUntimedActivations(untimed_count - flushed_count);
+        }
+    }
+
+    void ProfilerAggregator::ThreadTimersResults::MergeTo(const std::vector<TimerId>& timers_ids,
+                                                          std::vector<TimerResult>& results) const {
+        std::scoped_lock _(m_results_lock);
+        for (size_t index = 0; index < timers_ids.size(); index++) {
+            const auto timer_id = timers_ids[index];
+            if (timer_id < m_results.size())
+                results[index].Merge(m_results[timer_id]);
+
+            if (timer_id < m_untimed_counts.size()) {
+                const auto untimed_count = std::atomic_ref<const int64_t>(m_untimed_counts[timer_id]).load(std::memory_order_relaxed);
+                const auto flushed_count = timer_id < m_flushed_untimed_counts.size() ? m_flushed_untimed_counts[timer_id] : 0;
+                if (untimed_count > flushed_count)
+                    results[index].StoreUntimedActivations(untimed_count - flushed_count);
+            }
+        }
+    }
+
+    void ProfilerAggregator::ThreadTimersResults::MergeTo(CallTree& call_tree) const {
+        std::scoped_lock _(m_results_lock);
+        m_call_tree.MergeTo(call_tree);
+    }
+
+    void ProfilerAggregator::ThreadTimersResults::FlushTo(std::vector<TimerResult>& results) {
+        {
+            std::scoped_lock _(m_results_lock);
+            std::swap(m_results, m_spare_results);
+
+            // the counts aren't reset, since they are updated by the owner thread without lock
+            if (results.size() < m_untimed_counts.size())
+                results.resize(m_untimed_counts.size());
+            m_flushed_untimed_counts.resize(m_untimed_counts.size());
+            for (TimerId timer_id = 0; timer_id < m_untimed_counts.size(); timer_id++) {
+                const auto untimed_count = std::atomic_ref<int64_t>(m_untimed_counts[timer_id]).load(std::memory_order_relaxed);
+                results[timer_id].StoreUntimedActivations(untimed_count - m_flushed_untimed_counts[timer_id]);
+                m_flushed_untimed_counts[timer_id] = untimed_count;
+            }
+        }
+
+        // the spare table isn't used by the owner thread
+        if (results.size() < m_spare_results.size())
+            results.resize(m_spare_results.size());
+        for (TimerId timer_id = 0; timer_id < m_spare_results.size(); timer_id++) {
+            results[timer_id].Merge(m_spare_results[timer_id]);
+            m_spare_results[timer_id].Reset();
+        }
+    }
+
+    void ProfilerAggregator::ThreadTimersResults::CopyTo(std::vector<TraceEvent>& events) const {
+        std::scoped_lock _(m_results_lock);
+        if (m_trace_buffer)
+            m_trace_buffer->CopyTo(events);
+    }
+
+    TimerSite::TimerSite(
+        std::string_view _prefix,
+        std::string_view _file,
+        size_t _file_prefix_length,
+        int _line,
+        std::string_view _function,
+        bool _is_keyed) :
+        m_is_keyed(_is_keyed) {
+        if (_file.size() > _file_prefix_length)
+            _file.remove_prefix(_file_prefix_length);
+
+        m_location.append(_file).append(", ").append(std::to_string(_line)).append(" - ").append(_function);
+        if (m_is_keyed) {
+            static std::atomic<uint32_t> keyed_sites_count = 0;
+            m_id = keyed_sites_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        else {
+            m_id = ProfilerAggregator::RegisterTimer(std::string(_prefix) + m_location);
+        }
+    }
+
+    TimerId TimerSite::GetKeyId(std::string_view key) const {
+        assert(m_is_keyed);
+
+        struct KeyHash {
+            using is_transparent = void;
+            size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+        };
+        using KeysIds = std::unordered_map<std::string, TimerId, KeyHash, std::equal_to<>>;
+
+        // keys already met by the current thread, indexed by the keyed site,
+        // so the shared registry is accessed once per key and thread
+        thread_local std::vector<KeysIds> keys_ids;
+
+        if (keys_ids.size() <= m_id)
+            keys_ids.resize(m_id + 1);
+        auto& site_keys_ids = keys_ids[m_id];
+        if (auto it = site_keys_ids.find(key); site_keys_ids.end() != it)
+            return it->second;
+
+        auto timer_id = ProfilerAggregator::RegisterTimer(std::string(key) + ": " + m_location);
+        site_keys_ids.emplace(key, timer_id);
+        return timer_id;
+    }
 
     std::string scale_time_duration_ns(int64_t nanosec) {
         assert(nanosec >= 0);
@@ -31,14 +618,143 @@ namespace CU {
         return std::to_string(double(nanosec) * TIMESCALE) + " s.";
     }
 
+    void StreamProfilerSink::Write(ProfilerReportKind kind, int64_t interval_duration_ns, const TimersResults& results) {
+        const bool is_interval = ProfilerReportKind::INTERVAL == kind;
+
+        switch (m_format) {
+        case ProfilerReportFormat::TEXT:
+            if (is_interval)
+                m_os << "Profiler results for the last " << scale_time_duration_ns(interval_duration_ns) << std::endl;
+            else
+                m_os << "Profiler results:" << std::endl;
+
+            for (const auto& [timer_name, timer_result] : results) {
+                m_os << timer_name << ":" << std::endl;
+                m_os << timer_result << std::endl;
+            }
+            break;
+
+        case ProfilerReportFormat::CSV:
+            if (!m_is_csv_header_written) {
+                m_os << "report,interval_ns,timer,count,timed_count,total_ns,min_ns,max_ns,avg_ns,p50_ns,p90_ns,p99_ns,p99.9_ns,"
+                        "ipc,cache_misses_per_call,branch_misses_per_call\n";
+                m_is_csv_header_written = true;
+            }
+
+            for (const auto& [timer_name, timer_result] : results) {
+                m_os << (is_interval ? "interval," : "total,") << interval_duration_ns << ',';
+                write_csv_string(m_os, timer_name);
+                m_os << ',' << timer_result.m_activations_count
+                     << ',' << timer_result.GetTimedActivationsCount();
+                // durations are empty if all activations were skipped by sampling
+                if (timer_result.GetTimedActivationsCount()) {
+                    m_os << ',' << timer_result.GetEstimatedTotalNS()
+                         << ',' << timer_result.m_min_duration_ns
+                         << ',' << timer_result.m_max_duration_ns
+                         << ',' << timer_result.GetAvgNS();
+                }
+                else {
+                    m_os << ",,,,";
+                }
+                for (double percentile : { 50.0, 90.0, 99.0, 99.9 }) {
+                    m_os << ',';
+                    if (timer_result.HasPercentiles())
+                        m_os << timer_result.GetPercentileNS(percentile);
+                }
+                if (timer_result.HasHardwareCounters()) {
+                    m_os << ',' << timer_result.GetIPC()
+                         << ',' << timer_result.GetCacheMissesPerCall()
+                         << ',' << timer_result.GetBranchMissesPerCall();
+                }
+                else {
+                    m_os << ",,,";
+                }
+                m_os << '\n';
+            }
+            break;
+
+        case ProfilerReportFormat::JSON: {
+            m_os << "{\"report\":\"" << (is_interval ? "interval" : "total")
+                 << "\",\"interval_ns\":" << interval_duration_ns << ",\"timers\":[";
+
+            bool is_first_timer = true;
+            for (const auto& [timer_name, timer_result] : results) {
+                m_os << (is_first_timer ? "{\"name\":" : ",{\"name\":");
+                is_first_timer = false;
+                write_json_string(m_os, timer_name);
+                m_os << ",\"count\":" << timer_result.m_activations_count
+                     << ",\"timed_count\":" << timer_result.GetTimedActivationsCount();
+                if (timer_result.GetTimedActivationsCount()) {
+                    m_os << ",\"total_ns\":" << timer_result.GetEstimatedTotalNS()
+                         << ",\"min_ns\":" << timer_result.m_min_duration_ns
+                         << ",\"max_ns\":" << timer_result.m_max_duration_ns
+                         << ",\"avg_ns\":" << timer_result.GetAvgNS();
+                }
+                if (timer_result.HasPercentiles()) {
+                    m_os << ",\"p50_ns\":" << timer_result.GetPercentileNS(50.0)
+                         << ",\"p90_ns\":" << timer_result.GetPercentileNS(90.0)
+                         << ",\"p99_ns\":" << timer_result.GetPercentileNS(99.0)
+                         << ",\"p99.9_ns\":" << timer_result.GetPercentileNS(99.9);
+                }
+                if (timer_result.HasHardwareCounters()) {
+                    m_os << ",\"ipc\":" << timer_result.GetIPC()
+                         << ",\"cache_misses_per_call\":" << timer_result.GetCacheMissesPerCall()
+                         << ",\"branch_misses_per_call\":" << timer_result.GetBranchMissesPerCall();
+                }
+                m_os << '}';
+            }
+            m_os << "]}\n";
+            break;
+        }
+        }
+
+        m_os.flush();
+    }
+
+    FileProfilerSink::FileProfilerSink(const std::filesystem::path& _file_name, ProfilerReportFormat _format) :
+        m_file(_file_name),
+        m_stream_sink(m_file, _format) {
+    }
+
+    void FileProfilerSink::Write(ProfilerReportKind kind, int64_t interval_duration_ns, const TimersResults& results) {
+        if (m_file.is_open())
+            m_stream_sink.Write(kind, interval_duration_ns, results);
+    }
+
     std::ostream& operator<<(std::ostream& os, const TimerResult& tr) {
-        auto average_time = int64_t(double(tr.m_total_duration_ns) / double(tr.m_activations_count));
+        // all activations were skipped by sampling, there are no durations
+        if (!tr.GetTimedActivationsCount()) {
+            os << "\tactivations count = " << tr.m_activations_count << std::endl;
+            os << "\ttimed activations count = 0" << std::endl;
+            return os;
+        }
+
+        auto average_time = int64_t(double(tr.m_total_duration_ns) / double(tr.GetTimedActivationsCount()));
 
         os << "\tminimum duration = " << scale_time_duration_ns(tr.m_min_duration_ns) << std::endl;
         os << "\tmaximum duration = " << scale_time_duration_ns(tr.m_max_duration_ns) << std::endl;
         os << "\taverage duration = " << scale_time_duration_ns(average_time) << std::endl;
         os << "\tactivations count = " << tr.m_activations_count << std::endl;
-        os << "\ttotal = " << scale_time_duration_ns(tr.m_total_duration_ns) << std::endl;
+        if (tr.m_untimed_activations_count) {
+            os << "\ttimed activations count = " << tr.GetTimedActivationsCount() << std::endl;
+            os << "\testimated total = " << scale_time_duration_ns(tr.GetEstimatedTotalNS()) << std::endl;
+        }
+        else {
+            os << "\ttotal = " << scale_time_duration_ns(tr.m_total_duration_ns) << std::endl;
+        }
+
+        if (tr.HasPercentiles()) {
+            os << "\tp50 = "   << scale_time_duration_ns(tr.GetPercentileNS(50.0)) << std::endl;
+            os << "\tp90 = "   << scale_time_duration_ns(tr.GetPercentileNS(90.0)) << std::endl;
+            os << "\tp99 = "   << scale_time_duration_ns(tr.GetPercentileNS(99.0)) << std::endl;
+            os << "\tp99.9 = " << scale_time_duration_ns(tr.GetPercentileNS(99.9)) << std::endl;
+        }
+
+        if (tr.HasHardwareCounters()) {
+            os << "\tIPC = " << tr.GetIPC() << std::endl;
+            os << "\tcache misses per call = " << tr.GetCacheMissesPerCall() << std::endl;
+            os << "\tbranch misses per call = " << tr.GetBranchMissesPerCall() << std::endl;
+        }
 
         return os;
     }
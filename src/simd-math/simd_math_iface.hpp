@@ -0,0 +1,35 @@
+// Copyright (c) 2025, Yakov Usoltsev
+// Email: yakovmen62@gmail.com
+//
+// License: MIT
+
+// interface of the math kernels, included by the generated simd_math.hpp
+// every kernel has the variants CU::Math::<name>_<set> and the entry point CU::Math::<name>,
+// which calls the best variant supported by the current CPU
+
+#include <stdint.h>
+
+namespace CU::Math {
+    // reductions, the order of additions depends on the variant, so their results may differ in the last bits
+    CU_SIMD_FUNCTION(float, sum, const float* values, int64_t size)
+    CU_SIMD_FUNCTION(float, dot, const float* lhs, const float* rhs, int64_t size)
+
+    // NaN values are skipped, the result is +inf/-inf if there are no other values
+    CU_SIMD_FUNCTION(float, min, const float* values, int64_t size)
+    CU_SIMD_FUNCTION(float, max, const float* values, int64_t size)
+    // index of the first maximum, NaN values are skipped, -1 if there are no other values
+    CU_SIMD_FUNCTION(int64_t, argmax, const float* values, int64_t size)
+
+    // y = alpha * x + y
+    CU_SIMD_FUNCTION(void, axpy, float alpha, const float* x, float* y, int64_t size)
+
+    // elementwise approximations, the error is a few ulp
+    // results may be the same array as values
+    CU_SIMD_FUNCTION(void, exp, const float* values, int64_t size, float* results)
+    CU_SIMD_FUNCTION(void, log, const float* values, int64_t size, float* results)
+    CU_SIMD_FUNCTION(void, tanh, const float* values, int64_t size, float* results)
+
+    // true if every pair of values is equal as in CU::is_equal(lhs[i], rhs[i], absolute_epsilon, relative_epsilon)
+    CU_SIMD_FUNCTION(bool, is_equal, const float* lhs, const float* rhs, int64_t size,
+        float absolute_epsilon, float relative_epsilon)
+}
@@ -0,0 +1,276 @@
+// Copyright (c) 2025, Yakov Usoltsev
+// Email: yakovmen62@gmail.com
+//
+// License: MIT
+
+#include "simd_math.hpp"
+
+#include <cu/simd-vector-utils.hpp>
+#include <cu/math-utils.hpp>
+
+#include <limits>
+
+// The same kernels are compiled into every unit with the vectors of the unit.
+// The polynomial approximations of exp, log and tanh are taken from the Cephes library.
+namespace CU::Math {
+    using Vector = CU::Simd::Vector<float>;
+    using IntVector = CU::Simd::Vector<int32_t>;
+
+    static constexpr int64_t LANES = Vector::LANES;
+    static constexpr float INF = std::numeric_limits<float>::infinity();
+
+    // Calls step(accumulator, index) for the whole vectors of [0, size). Blocks of 4 vectors use
+    // independent accumulators to hide the latency of the operations, they are combined into the accumulator.
+    // Returns the index of the first value that isn't processed.
+    template<typename Step, typename Combine>
+    static int64_t reduce_vectors(int64_t size, Vector& accumulator, Step step, Combine combine) {
+        auto accumulator1 = accumulator;
+        auto accumulator2 = accumulator;
+        auto accumulator3 = accumulator;
+
+        const auto blocks_size = size - size % (4 * LANES);
+        int64_t index = 0;
+        for (; index < blocks_size; index += 4 * LANES) {
+            step(accumulator, index);
+            step(accumulator1, index + LANES);
+            step(accumulator2, index + 2 * LANES);
+            step(accumulator3, index + 3 * LANES);
+        }
+
+        const auto vectors_size = size - size % LANES;
+        for (; index < vectors_size; index += LANES) {
+            step(accumulator, index);
+        }
+
+        accumulator = combine(combine(accumulator, accumulator1), combine(accumulator2, accumulator3));
+        return index;
+    }
+
+    // results[i] = kernel(values[i]), the tail is processed by one partial vector
+    template<typename Kernel>
+    static void transform_vectors(const float* values, int64_t size, float* results, Kernel kernel) {
+        const auto vectors_size = size - size % LANES;
+        int64_t index = 0;
+        for (; index < vectors_size; index += LANES) {
+            kernel(Vector::Load(values + index)).Store(results + index);
+        }
+
+        if (index < size) {
+            const auto count = size - index;
+            kernel(Vector::LoadPartial(values + index, count)).StorePartial(results + index, count);
+        }
+    }
+
+    // 2^exponent for exponent in [-126, 127]
+    static Vector exp2_integer(const IntVector& exponent) {
+        return CU::Simd::bit_cast_to_float(CU::Simd::shift_left<23>(exponent + IntVector::Broadcast(127)));
+    }
+
+    static Vector exp_kernel(const Vector& x) {
+        // exp(x) = 2^n * exp(r), n = round(x / ln(2)), r = x - n * ln(2), |r| <= ln(2) / 2
+        // the limits give inf and 0 after the scaling, NaN is restored at the end
+        const auto clamped = CU::Simd::min(CU::Simd::max(x, Vector::Broadcast(-104.0f)), Vector::Broadcast(89.0f));
+        const auto n = CU::Simd::round(clamped * Vector::Broadcast(1.44269504088896341f));
+        // ln(2) is split in two parts, so n * 0.693359375 is exact
+        auto r = CU::Simd::mul_add(n, Vector::Broadcast(-0.693359375f), clamped);
+        r = CU::Simd::mul_add(n, Vector::Broadcast(2.12194440e-4f), r);
+
+        auto p = Vector::Broadcast(1.9875691500e-4f);
+        p = CU::Simd::mul_add(p, r, Vector::Broadcast(1.3981999507e-3f));
+        p = CU::Simd::mul_add(p, r, Vector::Broadcast(8.3334519073e-3f));
+        p = CU::Simd::mul_add(p, r, Vector::Broadcast(4.1665795894e-2f));
+        p = CU::Simd::mul_add(p, r, Vector::Broadcast(1.6666665459e-1f));
+        p = CU::Simd::mul_add(p, r, Vector::Broadcast(5.0000001201e-1f));
+        p = CU::Simd::mul_add(p * r, r, r + Vector::Broadcast(1.0f));
+
+        // n is in [-150, 128], it's applied in two halves, so the results are denormal or inf as expected
+        const auto exponent = CU::Simd::convert_to_int32(n);
+        const auto half_exponent = CU::Simd::shift_right<1>(exponent);
+        const auto result = p * exp2_integer(half_exponent) * exp2_integer(exponent - half_exponent);
+        return CU::Simd::select(x != x, x, result);
+    }
+
+    static Vector log_kernel(const Vector& x) {
+        // log(x) = e * ln(2) + log(1 + m), x = (1 + m) * 2^e, 1 + m is in [sqrt(0.5), sqrt(2))
+        // denormal values are scaled by 2^23 to get the mantissa from the bits
+        const auto is_denormal = x < Vector::Broadcast(std::numeric_limits<float>::min());
+        const auto bits = CU::Simd::bit_cast_to_int32(
+            CU::Simd::select(is_denormal, x * Vector::Broadcast(8388608.0f), x));
+        auto e = CU::Simd::convert_to_float(
+            (CU::Simd::shift_right<23>(bits) & IntVector::Broadcast(0xFF)) - IntVector::Broadcast(126));
+        e -= CU::Simd::select(is_denormal, Vector::Broadcast(23.0f), Vector::Zero());
+        // the mantissa in [0.5, 1)
+        auto m = CU::Simd::bit_cast_to_float(
+            (bits & IntVector::Broadcast(0x007FFFFF)) | IntVector::Broadcast(0x3F000000));
+
+        const auto is_small = m < Vector::Broadcast(0.707106781186547524f);
+        e = CU::Simd::select(is_small, e - Vector::Broadcast(1.0f), e);
+        m = CU::Simd::select(is_small, m + m, m) - Vector::Broadcast(1.0f);
+
+        const auto z = m * m;
+        auto p = Vector::Broadcast(7.0376836292e-2f);
+        p = CU::Simd::mul_add(p, m, Vector::Broadcast(-1.1514610310e-1f));
+        p = CU::Simd::mul_add(p, m, Vector::Broadcast(1.1676998740e-1f));
+        p = CU::Simd::mul_add(p, m, Vector::Broadcast(-1.2420140846e-1f));
+        p = CU::Simd::mul_add(p, m, Vector::Broadcast(1.4249322787e-1f));
+        p = CU::Simd::mul_add(p, m, Vector::Broadcast(-1.6668057665e-1f));
+        p = CU::Simd::mul_add(p, m, Vector::Broadcast(2.0000714765e-1f));
+        p = CU::Simd::mul_add(p, m, Vector::Broadcast(-2.4999993993e-1f));
+        p = CU::Simd::mul_add(p, m, Vector::Broadcast(3.3333331174e-1f));
+
+        auto y = p * m * z;
+        y = CU::Simd::mul_add(e, Vector::Broadcast(-2.12194440e-4f), y);
+        y = CU::Simd::mul_add(z, Vector::Broadcast(-0.5f), y);
+        auto result = CU::Simd::mul_add(e, Vector::Broadcast(0.693359375f), m + y);
+
+        result = CU::Simd::select(x == Vector::Broadcast(INF), x, result);
+        result = CU::Simd::select(x < Vector::Zero(), Vector::Broadcast(std::numeric_limits<float>::quiet_NaN()), result);
+        result = CU::Simd::select(x == Vector::Zero(), Vector::Broadcast(-INF), result);
+        return CU::Simd::select(x != x, x, result);
+    }
+
+    static Vector tanh_kernel(const Vector& x) {
+        // the odd polynomial for |x| < 0.625, otherwise sign(x) * (1 - 2 / (exp(2 * |x|) + 1))
+        const auto z = x * x;
+        auto p = Vector::Broadcast(-5.70498872745e-3f);
+        p = CU::Simd::mul_add(p, z, Vector::Broadcast(2.06390887954e-2f));
+        p = CU::Simd::mul_add(p, z, Vector::Broadcast(-5.37397155531e-2f));
+        p = CU::Simd::mul_add(p, z, Vector::Broadcast(1.33314422036e-1f));
+        p = CU::Simd::mul_add(p, z, Vector::Broadcast(-3.33332819422e-1f));
+        const auto small = CU::Simd::mul_add(p * z, x, x);
+
+        const auto a = CU::Simd::abs(x);
+        const auto one = Vector::Broadcast(1.0f);
+        auto large = one - Vector::Broadcast(2.0f) / (exp_kernel(a + a) + one);
+        large = CU::Simd::select(x < Vector::Zero(), -large, large);
+
+        return CU::Simd::select(a < Vector::Broadcast(0.625f), small, large);
+    }
+
+    float CU_SIMD(sum)(const float* values, int64_t size) {
+        auto accumulator = Vector::Zero();
+        auto index = reduce_vectors(size, accumulator,
+            [values](Vector& sum, int64_t offset) { sum += Vector::Load(values + offset); },
+            [](const Vector& lhs, const Vector& rhs) { return lhs + rhs; });
+
+        auto result = CU::Simd::reduce_add(accumulator);
+        for (; index < size; index++) {
+            result += values[index];
+        }
+        return result;
+    }
+
+    float CU_SIMD(dot)(const float* lhs, const float* rhs, int64_t size) {
+        auto accumulator = Vector::Zero();
+        auto index = reduce_vectors(size, accumulator,
+            [lhs, rhs](Vector& sum, int64_t offset) {
+                sum = CU::Simd::mul_add(Vector::Load(lhs + offset), Vector::Load(rhs + offset), sum);
+            },
+            [](const Vector& x, const Vector& y) { return x + y; });
+
+        auto result = CU::Simd::reduce_add(accumulator);
+        for (; index < size; index++) {
+            result += lhs[index] * rhs[index];
+        }
+        return result;
+    }
+
+    // min and max return the second argument for NaN, so the accumulator is always the second one
+
+    float CU_SIMD(min)(const float* values, int64_t size) {
+        auto accumulator = Vector::Broadcast(INF);
+        auto index = reduce_vectors(size, accumulator,
+            [values](Vector& minimum, int64_t offset) { minimum = CU::Simd::min(Vector::Load(values + offset), minimum); },
+            [](const Vector& lhs, const Vector& rhs) { return CU::Simd::min(lhs, rhs); });
+
+        auto result = CU::Simd::reduce_min(accumulator);
+        for (; index < size; index++) {
+            result = values[index] < result ? values[index] : result;
+        }
+        return result;
+    }
+
+    float CU_SIMD(max)(const float* values, int64_t size) {
+        auto accumulator = Vector::Broadcast(-INF);
+        auto index = reduce_vectors(size, accumulator,
+            [values](Vector& maximum, int64_t offset) { maximum = CU::Simd::max(Vector::Load(values + offset), maximum); },
+            [](const Vector& lhs, const Vector& rhs) { return CU::Simd::max(lhs, rhs); });
+
+        auto result = CU::Simd::reduce_max(accumulator);
+        for (; index < size; index++) {
+            result = values[index] > result ? values[index] : result;
+        }
+        return result;
+    }
+
+    int64_t CU_SIMD(argmax)(const float* values, int64_t size) {
+        // the maximum is found first, then the first value equal to it
+        const auto maximum = CU_SIMD(max)(values, size);
+        const auto broadcast_maximum = Vector::Broadcast(maximum);
+
+        const auto vectors_size = size - size % LANES;
+        int64_t index = 0;
+        for (; index < vectors_size; index += LANES) {
+            const auto is_maximum = Vector::Load(values + index) == broadcast_maximum;
+            if (CU::Simd::any(is_maximum))
+                return index + CU::Simd::find_first(is_maximum);
+        }
+
+        for (; index < size; index++) {
+            if (values[index] == maximum)
+                return index;
+        }
+        return -1;
+    }
+
+    void CU_SIMD(axpy)(float alpha, const float* x, float* y, int64_t size) {
+        const auto broadcast_alpha = Vector::Broadcast(alpha);
+        const auto vectors_size = size - size % LANES;
+        int64_t index = 0;
+        for (; index < vectors_size; index += LANES) {
+            CU::Simd::mul_add(broadcast_alpha, Vector::Load(x + index), Vector::Load(y + index)).Store(y + index);
+        }
+
+        if (index < size) {
+            const auto count = size - index;
+            CU::Simd::mul_add(broadcast_alpha, Vector::LoadPartial(x + index, count), Vector::LoadPartial(y + index, count))
+                .StorePartial(y + index, count);
+        }
+    }
+
+    void CU_SIMD(exp)(const float* values, int64_t size, float* results) {
+        transform_vectors(values, size, results, exp_kernel);
+    }
+
+    void CU_SIMD(log)(const float* values, int64_t size, float* results) {
+        transform_vectors(values, size, results, log_kernel);
+    }
+
+    void CU_SIMD(tanh)(const float* values, int64_t size, float* results) {
+        transform_vectors(values, size, results, tanh_kernel);
+    }
+
+    bool CU_SIMD(is_equal)(const float* lhs, const float* rhs, int64_t size,
+            float absolute_epsilon, float relative_epsilon) {
+        const auto broadcast_absolute = Vector::Broadcast(absolute_epsilon);
+        const auto broadcast_relative = Vector::Broadcast(relative_epsilon);
+
+        const auto vectors_size = size - size % LANES;
+        int64_t index = 0;
+        for (; index < vectors_size; index += LANES) {
+            const auto x = Vector::Load(lhs + index);
+            const auto y = Vector::Load(rhs + index);
+            const auto delta = CU::Simd::abs(x - y);
+            const auto is_equal_values = (delta < broadcast_absolute) |
+                (delta < broadcast_relative * CU::Simd::max(CU::Simd::abs(x), CU::Simd::abs(y)));
+            if (!CU::Simd::all(is_equal_values))
+                return false;
+        }
+
+        for (; index < size; index++) {
+            if (!CU::is_equal(lhs[index], rhs[index], absolute_epsilon, relative_epsilon))
+                return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,222 @@
+// Copyright (c) 2025, Yakov Usoltsev
+// Email: yakovmen62@gmail.com
+//
+// License: MIT
+
+#include <cu/file-utils.hpp>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <random>
+#include <cmath>
+#include <limits>
+
+static std::filesystem::path get_temp_file_path(const std::string& name) {
+    return std::filesystem::temp_directory_path() / ("cu-file-test-" + name);
+}
+
+TEST(MappedFileViewTest, SameAsLoad) {
+    const auto file_name = get_temp_file_path("mapped.bin");
+    std::vector<float> values(100000);
+    std::iota(values.begin(), values.end(), 0.5f);
+    ASSERT_TRUE(CU::save_data_to_file(file_name, values));
+
+    const auto loaded = CU::load_data_from_file<float>(file_name);
+    auto mapped = CU::map_data_from_file<float>(file_name);
+    ASSERT_EQ(mapped.size(), values.size());
+    ASSERT_TRUE(std::equal(mapped.begin(), mapped.end(), loaded.begin(), loaded.end()));
+    ASSERT_EQ(mapped.as_span().back(), values.back());
+
+    mapped.Advise(CU::MappedFileAccess::RANDOM);
+    ASSERT_EQ(mapped[12345], values[12345]);
+
+    // the view is movable, the file stays mapped by the new owner
+    auto moved = std::move(mapped);
+    ASSERT_TRUE(mapped.empty());
+    ASSERT_EQ(moved[0], values[0]);
+
+    std::filesystem::remove(file_name);
+}
+
+TEST(MappedFileViewTest, InvalidFiles) {
+    ASSERT_TRUE(CU::map_data_from_file<int>(get_temp_file_path("missing.bin")).empty());
+
+    const auto file_name = get_temp_file_path("partial.bin");
+    const std::vector<uint8_t> bytes(10, 1);
+    ASSERT_TRUE(CU::save_data_to_file(file_name, bytes));
+
+    // the tail that doesn't fill a whole unit is ignored, as in load_data_from_file
+    const auto mapped = CU::map_data_from_file<uint32_t>(file_name);
+    ASSERT_EQ(mapped.size(), 2);
+    ASSERT_EQ(mapped[1], 0x01010101u);
+
+    ASSERT_TRUE(CU::save_data_to_file(file_name, std::vector<uint8_t>{}));
+    ASSERT_TRUE(CU::map_data_from_file<uint8_t>(file_name).empty());
+
+    std::filesystem::remove(file_name);
+}
+
+TEST(ChunkedFileTest, ReadWrite) {
+    const auto file_name = get_temp_file_path("chunked.bin");
+    std::vector<int32_t> values(10000);
+    std::iota(values.begin(), values.end(), -5000);
+
+    // the chunk size isn't a divisor of the values count
+    {
+        CU::ChunkedFileWriter<int32_t> writer{ file_name, 768 };
+        ASSERT_TRUE(writer.Write(std::span(values).first(1000)));
+        ASSERT_TRUE(writer.Write(std::span(values).subspan(1000)));
+        ASSERT_TRUE(writer.Flush());
+    }
+    ASSERT_EQ(CU::load_data_from_file<int32_t>(file_name), values);
+
+    CU::ChunkedFileReader<int32_t> reader{ file_name, 768 };
+    std::vector<int32_t> read_values;
+    for (auto chunk = reader.Next(); !chunk.empty(); chunk = reader.Next()) {
+        ASSERT_LE(chunk.size(), 768);
+        ASSERT_EQ(reinterpret_cast<std::uintptr_t>(chunk.data()) % 64, 0);
+        read_values.insert(read_values.end(), chunk.begin(), chunk.end());
+    }
+    ASSERT_TRUE(reader.Next().empty());
+    ASSERT_FALSE(reader.IsFailed());
+    ASSERT_EQ(read_values, values);
+
+    CU::ChunkedFileReader<int32_t> missing_reader{ get_temp_file_path("missing.bin") };
+    ASSERT_TRUE(missing_reader.Next().empty());
+    ASSERT_TRUE(missing_reader.IsFailed());
+
+    std::filesystem::remove(file_name);
+}
+
+TEST(ChunkedFileTest, Transform) {
+    const auto input_file_name = get_temp_file_path("input.bin");
+    const auto output_file_name = get_temp_file_path("output.bin");
+    std::vector<float> values(100000);
+    std::iota(values.begin(), values.end(), 0.0f);
+    ASSERT_TRUE(CU::save_data_to_file(input_file_name, values));
+
+    ASSERT_TRUE(CU::transform_file_by_chunks<float>(input_file_name, output_file_name,
+        [](const float* input, int64_t size, float* output) {
+            std::transform(input, input + size, output, [](float value) { return value * 2.0f; });
+        }, 4096));
+
+    const auto result = CU::load_data_from_file<float>(output_file_name);
+    ASSERT_EQ(result.size(), values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        ASSERT_EQ(result[i], values[i] * 2.0f);
+    }
+
+    std::filesystem::remove(input_file_name);
+    std::filesystem::remove(output_file_name);
+
+    // the output isn't created for the missing input
+    ASSERT_FALSE(CU::transform_file_by_chunks<float>(input_file_name, output_file_name,
+        [](const float*, int64_t, float*) {}));
+    ASSERT_FALSE(std::filesystem::exists(output_file_name));
+}
+
+TEST(TextDataTest, Parse) {
+    ASSERT_EQ(CU::parse_text_data<int>(" 1\t-2\n+3  4\r\n"), (std::vector<int>{ 1, -2, 3, 4 }));
+    ASSERT_EQ(CU::parse_text_data<float>("1.5,-2e3;;.25", ",;"), (std::vector<float>{ 1.5f, -2e3f, 0.25f }));
+
+    // unsupported blocks are skipped, the rest of the values is kept
+    ASSERT_EQ(CU::parse_text_data<int>("1 abc 2 3x 1-2 -"), (std::vector<int>{ 1, 2, 3, 1, -2 }));
+    ASSERT_EQ(CU::parse_text_data<uint16_t>("65535 65536 1"), (std::vector<uint16_t>{ 65535, 1 }));
+    ASSERT_EQ(CU::parse_text_data<bool>("0 1 2"), (std::vector<bool>{ false, true }));
+    ASSERT_EQ(CU::parse_text_data<char>("ab c"), (std::vector<char>{ 'a', 'b', 'c' }));
+
+    // long tokens and many delimiters cross the vector search boundaries
+    std::string text;
+    std::vector<double> values;
+    for (int i = 0; i < 1000; i++) {
+        values.push_back(i * 1234.5678);
+        text += std::to_string(values.back()) + (i % 3 ? "|" : " |\n");
+    }
+    const auto parsed = CU::parse_text_data<double>(text, "|");
+    ASSERT_EQ(parsed.size(), values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        ASSERT_NEAR(parsed[i], values[i], 1.0e-6);
+    }
+}
+
+TEST(TextDataTest, LoadFile) {
+    const auto file_name = get_temp_file_path("text.csv");
+    std::ofstream{ file_name } << "1,2, 3\n4 ,x,5\n";
+    ASSERT_EQ(CU::load_data_from_text_file<int64_t>(file_name, ","), (std::vector<int64_t>{ 1, 2, 3, 4, 5 }));
+    ASSERT_TRUE(CU::load_data_from_text_file<int>(get_temp_file_path("missing.txt")).empty());
+    std::filesystem::remove(file_name);
+}
+
+template<typename Unit>
+static std::string format_like_stream(const std::vector<Unit>& values) {
+    std::ostringstream stream;
+    for (const auto& value : values) {
+        stream << value << std::endl;
+    }
+    return stream.str();
+}
+
+template<typename Unit>
+static std::string save_and_read_text(const std::vector<Unit>& values, const CU::TextWriterConfiguration& configuration = {}) {
+    const auto file_name = get_temp_file_path("written.txt");
+    EXPECT_TRUE(CU::save_data_to_text_file(file_name, values, configuration));
+    std::ifstream file_reader{ file_name };
+    std::string text{ std::istreambuf_iterator<char>(file_reader), std::istreambuf_iterator<char>() };
+    std::filesystem::remove(file_name);
+    return text;
+}
+
+TEST(TextDataTest, SameAsStream) {
+    std::mt19937_64 generator{ 42 };
+    std::vector<double> doubles;
+    std::vector<float> floats;
+    std::vector<int64_t> integers;
+    for (int i = 0; i < 10000; i++) {
+        const auto bits = generator();
+        const auto exponent = int(bits % 80) - 40;
+        doubles.push_back(std::ldexp(double(int64_t(bits)), exponent - 63));
+        floats.push_back(float(doubles.back()));
+        integers.push_back(int64_t(bits) >> (bits % 64));
+    }
+    doubles.insert(doubles.end(), { 0.0, -0.0, 1.0e100, 123456.5, 1.0e-5, std::numeric_limits<double>::infinity() });
+
+    ASSERT_EQ(save_and_read_text(doubles), format_like_stream(doubles));
+    ASSERT_EQ(save_and_read_text(floats), format_like_stream(floats));
+    ASSERT_EQ(save_and_read_text(integers), format_like_stream(integers));
+    ASSERT_EQ(save_and_read_text(std::vector<int8_t>{ 65, 66 }), format_like_stream(std::vector<int8_t>{ 65, 66 }));
+    ASSERT_EQ(save_and_read_text(std::vector<long double>{ 1.0L / 3, 1.0e300L }),
+              format_like_stream(std::vector<long double>{ 1.0L / 3, 1.0e300L }));
+
+    // parallel formatting keeps the order of values
+    ASSERT_EQ(save_and_read_text(doubles, { .m_threads_count = 4, .m_min_values_per_thread = 100 }),
+              format_like_stream(doubles));
+}
+
+TEST(TextDataTest, WriterConfiguration) {
+    const std::vector<double> values{ 0.1, 1.0 / 3, -2.5 };
+    ASSERT_EQ(save_and_read_text(values, { .m_delimiter = ", ", .m_precision = 3 }), "0.1, 0.333, -2.5, ");
+
+    // the shortest representation reads back exactly
+    const auto text = save_and_read_text(values, { .m_delimiter = ",", .m_is_shortest = true });
+    ASSERT_EQ(text, "0.1,0.3333333333333333,-2.5,");
+    ASSERT_EQ(CU::parse_text_data<double>(text, ","), values);
+
+    // the value doesn't fit the initial block
+    ASSERT_EQ(save_and_read_text(std::vector<double>{ 1.0 }, { .m_precision = 200 }), "1\n");
+    const auto tiny_value = std::numeric_limits<double>::denorm_min();
+    std::ostringstream stream;
+    stream << std::setprecision(800) << tiny_value << std::endl;
+    ASSERT_EQ(save_and_read_text(std::vector<double>{ tiny_value }, { .m_precision = 800 }), stream.str());
+}
+
+int main(int argc, char* argv[]) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
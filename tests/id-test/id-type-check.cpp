@@ -0,0 +1,16 @@
+// Copyright (c) 2025, Yakov Usoltsev
+// Email: yakovmen62@gmail.com
+//
+// License: MIT
+
+// compile check of id-utils.hpp with 64-bit CU_ID_TYPE (defined by CMakeLists.txt),
+// it isn't linked to id-test, which uses the default type
+#include <cu/id-utils.hpp>
+
+static_assert(sizeof(CU::id_t) == sizeof(uint64_t));
+
+template class CU::IdPoolT<CU::id_t>;
+template class CU::BitmapIdPoolT<CU::id_t>;
+template class CU::ConcurrentIdPoolT<CU::id_t>;
+template class CU::GenerationalHandleT<CU::id_t>;
+template class CU::SlotMap<int>;
@@ -8,6 +8,14 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
 
 TEST(IdPoolTest, BaseFunctional) {
     CU::IdPool id_pool{};
@@ -37,6 +45,249 @@ TEST(IdPoolTest, BaseFunctional) {
     ASSERT_EQ(id_pool.LockId(), 2);
 }
 
+TEST(BitmapIdPoolTest, BaseFunctional) {
+    CU::BitmapIdPool id_pool{};
+    ASSERT_EQ(id_pool.LockId(), 0);
+    ASSERT_EQ(id_pool.LockId(), 1);
+    ASSERT_EQ(id_pool.LockId(), 2);
+    ASSERT_EQ(id_pool.LockId(), 3);
+
+    id_pool.FreeId(2);
+    ASSERT_EQ(id_pool.LockId(), 2);
+
+    id_pool.FreeId(2);
+    id_pool.FreeId(1);
+    ASSERT_EQ(id_pool.LockId(), 1);
+
+    id_pool.FreeId(1);
+    id_pool.FreeId(3);
+    ASSERT_EQ(id_pool.LockId(), 1);
+    ASSERT_EQ(id_pool.LockId(), 2);
+    ASSERT_EQ(id_pool.LockId(), 3);
+
+    id_pool.FreeId(3);
+    ASSERT_EQ(id_pool.LockId(), 3);
+
+    id_pool.FreeId(3);
+    id_pool.FreeId(2);
+    ASSERT_EQ(id_pool.LockId(), 2);
+}
+
+TEST(BitmapIdPoolTest, SameAsIdPool) {
+    constexpr size_t operations_count = 1'000'000;
+    CU::IdPool id_pool{};
+    CU::BitmapIdPool bitmap_id_pool{};
+    std::vector<CU::id_t> locked_ids;
+
+    std::mt19937 generator{ 42 };
+    for (size_t i = 0; i < operations_count; i++) {
+        // locks prevail at the beginning, so the pools grow over several levels of the bitmap
+        if (locked_ids.empty() || generator() % 16 < (i < operations_count / 2 ? 11u : 5u)) {
+            const auto id = id_pool.LockId();
+            ASSERT_EQ(bitmap_id_pool.LockId(), id);
+            locked_ids.push_back(id);
+        }
+        else {
+            const auto index = generator() % locked_ids.size();
+            const auto id = locked_ids[index];
+            locked_ids[index] = locked_ids.back();
+            locked_ids.pop_back();
+
+            id_pool.FreeId(id);
+            bitmap_id_pool.FreeId(id);
+            ASSERT_FALSE(bitmap_id_pool.CheckId(id));
+        }
+    }
+
+    for (auto id : locked_ids) {
+        ASSERT_TRUE(bitmap_id_pool.CheckId(id));
+    }
+}
+
+TEST(ConcurrentIdPoolTest, BaseFunctional) {
+    CU::ConcurrentIdPoolT<uint32_t> id_pool{ 3 };
+    ASSERT_EQ(id_pool.LockId(), 0);
+    ASSERT_EQ(id_pool.LockId(), 1);
+    ASSERT_EQ(id_pool.LockId(), 2);
+    ASSERT_EQ(id_pool.LockId(), CU::INVALID_ID);
+
+    id_pool.FreeId(1);
+    ASSERT_FALSE(id_pool.CheckId(1));
+    id_pool.FreeId(0);
+    ASSERT_EQ(id_pool.LockId(), 0);
+    ASSERT_EQ(id_pool.LockId(), 1);
+    ASSERT_TRUE(id_pool.CheckId(1));
+    ASSERT_EQ(id_pool.LockId(), CU::INVALID_ID);
+}
+
+TEST(ConcurrentIdPoolTest, IdTypes) {
+    // the head keeps 32 bits of the identifier, the end of the free list is mapped for any type
+    CU::ConcurrentIdPoolT<uint64_t> wide_pool{ 2 };
+    ASSERT_EQ(wide_pool.LockId(), 0u);
+    ASSERT_EQ(wide_pool.LockId(), 1u);
+    ASSERT_EQ(wide_pool.LockId(), std::numeric_limits<uint64_t>::max());
+    wide_pool.FreeId(0);
+    ASSERT_EQ(wide_pool.LockId(), 0u);
+    ASSERT_EQ(wide_pool.LockId(), std::numeric_limits<uint64_t>::max());
+
+    // the two greatest values are reserved by the pool
+    CU::ConcurrentIdPoolT<uint8_t> narrow_pool{ 253 };
+    for (uint8_t id = 0; id < 253; id++) {
+        ASSERT_EQ(narrow_pool.LockId(), id);
+    }
+    ASSERT_EQ(narrow_pool.LockId(), std::numeric_limits<uint8_t>::max());
+    narrow_pool.FreeId(252);
+    ASSERT_EQ(narrow_pool.LockId(), 252);
+}
+
+TEST(ConcurrentIdPoolTest, Multithread) {
+    constexpr size_t threads_count = 8;
+    constexpr size_t ids_per_thread = 64;
+    constexpr size_t iterations_count = 2000;
+    CU::ConcurrentIdPool id_pool{ threads_count * ids_per_thread };
+
+    std::vector<std::vector<CU::id_t>> locked_ids(threads_count);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threads_count; i++) {
+        threads.emplace_back([&id_pool, &thread_ids = locked_ids[i]] {
+            for (size_t iteration = 0; iteration < iterations_count; iteration++) {
+                for (size_t j = 0; j < ids_per_thread; j++) {
+                    thread_ids.push_back(id_pool.LockId());
+                }
+                if (iteration + 1 == iterations_count)
+                    break;
+
+                for (auto id : thread_ids) {
+                    id_pool.FreeId(id);
+                }
+                thread_ids.clear();
+            }
+            });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // all identifiers of the pool are locked exactly once
+    std::vector<size_t> lock_counts(threads_count * ids_per_thread);
+    for (const auto& thread_ids : locked_ids) {
+        for (auto id : thread_ids) {
+            ASSERT_LT(id, lock_counts.size());
+            lock_counts[id]++;
+        }
+    }
+    for (size_t i = 0; i < lock_counts.size(); i++) {
+        ASSERT_EQ(lock_counts[i], 1);
+    }
+}
+
+TEST(GenerationalHandleTest, Packing) {
+    constexpr CU::GenerationalId handle{ 0x1234, 0xabcd };
+    static_assert(handle.GetPacked() == 0xabcd1234);
+    static_assert(handle.GetIndex() == 0x1234 && handle.GetGeneration() == 0xabcd);
+    static_assert(CU::GenerationalId::FromPacked(handle.GetPacked()) == handle);
+    static_assert(!CU::GenerationalUid{}.IsValid());
+    static_assert(CU::GenerationalUid{ 1, 2 }.GetPacked() == 0x0000000200000001);
+}
+
+TEST(SlotMapTest, StaleHandles) {
+    CU::SlotMap<std::string> slot_map;
+    const auto first = slot_map.Insert("first");
+    const auto second = slot_map.Insert("second");
+    const auto third = slot_map.Insert("third");
+    ASSERT_EQ(slot_map.Size(), 3);
+
+    ASSERT_TRUE(slot_map.Erase(first));
+    ASSERT_FALSE(slot_map.Erase(first));
+    ASSERT_EQ(slot_map.Find(first), nullptr);
+    ASSERT_EQ(*slot_map.Find(third), "third");
+
+    // the slot of the erased object is reused with the new generation
+    const auto fourth = slot_map.Insert("fourth");
+    ASSERT_EQ(fourth.GetIndex(), first.GetIndex());
+    ASSERT_NE(fourth, first);
+    ASSERT_EQ(slot_map.Find(first), nullptr);
+    ASSERT_EQ(*slot_map.Find(fourth), "fourth");
+
+    // the forged handle of the free slot isn't accepted
+    ASSERT_TRUE(slot_map.Erase(second));
+    ASSERT_FALSE(slot_map.Contains(CU::GenerationalId(second.GetIndex(), second.GetGeneration() + 1)));
+
+    ASSERT_EQ(slot_map.Size(), 2);
+    const std::set<std::string> values(slot_map.begin(), slot_map.end());
+    ASSERT_EQ(values, std::set<std::string>({ "fourth", "third" }));
+    for (size_t i = 0; i < slot_map.Size(); i++) {
+        ASSERT_EQ(slot_map.Find(slot_map.GetHandle(i)), &*(slot_map.begin() + i));
+    }
+}
+
+TEST(SlotMapTest, RetiredSlots) {
+    CU::SlotMap<int, CU::GenerationalHandleT<uint16_t>> slot_map;
+    auto handle = slot_map.Insert(0);
+    const auto slot_index = handle.GetIndex();
+    for (int i = 1; i < 256; i++) {
+        ASSERT_TRUE(slot_map.Erase(handle));
+        handle = slot_map.Insert(i);
+        ASSERT_EQ(handle.GetIndex(), slot_index);
+        ASSERT_EQ(handle.GetGeneration(), i);
+    }
+
+    // the generation is exhausted, so a new slot is used
+    ASSERT_TRUE(slot_map.Erase(handle));
+    ASSERT_NE(slot_map.Insert(0).GetIndex(), slot_index);
+}
+
+TEST(SlotMapTest, ThrowingConstructor) {
+    struct Value {
+        explicit Value(int value) : m_value(value) {
+            if (value < 0)
+                throw std::invalid_argument("negative value");
+        }
+        int m_value;
+    };
+
+    CU::SlotMap<Value> slot_map;
+    const auto first = slot_map.Emplace(1);
+    const auto second = slot_map.Emplace(2);
+    ASSERT_THROW(slot_map.Emplace(-1), std::invalid_argument);
+    ASSERT_EQ(slot_map.Size(), 2u);
+
+    // the throw doesn't lose the free slot, and the erase after it moves the right object
+    ASSERT_TRUE(slot_map.Erase(first));
+    ASSERT_THROW(slot_map.Emplace(-1), std::invalid_argument);
+    const auto third = slot_map.Emplace(3);
+    ASSERT_EQ(third.GetIndex(), first.GetIndex());
+    ASSERT_EQ(slot_map.Find(second)->m_value, 2);
+    ASSERT_EQ(slot_map.Find(third)->m_value, 3);
+    ASSERT_TRUE(slot_map.Erase(second));
+    ASSERT_EQ(slot_map.Find(third)->m_value, 3);
+    ASSERT_EQ(slot_map.Size(), 1u);
+    ASSERT_FALSE(slot_map.Contains(first));
+}
+
+TEST(UniqueNameTest, FormatAndParse) {
+    const auto unique_name = CU::concat_with_uid("object", 0x1a2b);
+    ASSERT_EQ(unique_name, "object {0000000000001a2b}");
+    ASSERT_TRUE(CU::is_contains_uid(unique_name));
+    ASSERT_EQ(CU::uid_extract_name(unique_name), "object");
+    ASSERT_EQ(CU::extract_uid(unique_name), 0x1a2b);
+
+    std::array<char, 32> buffer{};
+    const auto max_uid_name = CU::concat_with_uid("", std::numeric_limits<CU::uid_t>::max(), buffer);
+    ASSERT_EQ(max_uid_name, " {ffffffffffffffff}");
+    ASSERT_EQ(CU::uid_extract_name_view(max_uid_name), "");
+    ASSERT_EQ(CU::extract_uid(max_uid_name), std::numeric_limits<CU::uid_t>::max());
+    ASSERT_EQ(CU::extract_uid("object {00000000ABCDEF09}"), 0xabcdef09);
+
+    // the buffer is too small
+    ASSERT_TRUE(CU::concat_with_uid("long object name", 1, buffer).empty());
+
+    ASSERT_FALSE(CU::is_contains_uid("object"));
+    ASSERT_FALSE(CU::is_contains_uid("object {000000000000001a2b}"));
+    ASSERT_FALSE(CU::is_contains_uid("object_{0000000000001a2b}"));
+    ASSERT_FALSE(CU::is_contains_uid("object {000000000000g1a2b}"));
+}
+
 TEST(UidGeneratorTest, UniqueImpl) {
     // first instantiation is ok
     EXPECT_NO_THROW(CU::UidGeneratorT<uint32_t>::Get());
@@ -64,6 +315,89 @@ TEST(UidGeneratorTest, BaseFunctional) {
     }
 }
 
+TEST(UidGeneratorTest, ThreadBlocks) {
+    constexpr size_t threads_count = 8;
+    constexpr size_t uids_per_thread = 1000;
+
+    std::vector<std::vector<uint32_t>> uids(threads_count);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threads_count; i++) {
+        threads.emplace_back([&thread_uids = uids[i]] {
+            for (size_t j = 0; j < uids_per_thread; j++) {
+                thread_uids.push_back(j % 2 ? CU::UidGeneratorT<uint32_t>::Get()
+                                            : CU::UidGeneratorT<uint32_t>::GetFromThreadBlock<64>());
+            }
+            });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::unordered_set<uint32_t> all_uids;
+    for (const auto& thread_uids : uids) {
+        all_uids.insert(thread_uids.begin(), thread_uids.end());
+    }
+    ASSERT_EQ(all_uids.size(), threads_count * uids_per_thread);
+}
+
+TEST(SnowflakeUidGeneratorTest, BaseFunctional) {
+    using Snowflake = CU::SnowflakeUidGenerator;
+    ASSERT_THROW(Snowflake::SetWorkerId(Snowflake::MAX_WORKER_ID + 1), std::invalid_argument);
+    Snowflake::SetWorkerId(42);
+
+    const auto before = std::chrono::time_point_cast<std::chrono::milliseconds>(std::chrono::system_clock::now());
+    const auto uid = Snowflake::Get();
+    ASSERT_EQ(Snowflake::GetWorkerId(uid), 42);
+    ASSERT_GE(Snowflake::GetTime(uid), before);
+
+    // a burst larger than the sequence space of a millisecond stays increasing
+    auto previous = uid;
+    for (size_t i = 0; i < 3 * (size_t(1) << Snowflake::SEQUENCE_BITS); i++) {
+        const auto current = Snowflake::Get();
+        ASSERT_GT(current, previous);
+        ASSERT_EQ(Snowflake::GetWorkerId(current), 42);
+        previous = current;
+    }
+    Snowflake::SetWorkerId(0);
+}
+
+TEST(SnowflakeUidGeneratorTest, Multithread) {
+    constexpr size_t threads_count = 8;
+    constexpr size_t uids_per_thread = 10000;
+
+    std::vector<std::vector<uint64_t>> uids(threads_count);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threads_count; i++) {
+        threads.emplace_back([&thread_uids = uids[i]] {
+            for (size_t j = 0; j < uids_per_thread; j++) {
+                thread_uids.push_back(CU::SnowflakeUidGenerator::Get());
+            }
+            });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::unordered_set<uint64_t> all_uids;
+    for (const auto& thread_uids : uids) {
+        ASSERT_TRUE(std::is_sorted(thread_uids.begin(), thread_uids.end()));
+        all_uids.insert(thread_uids.begin(), thread_uids.end());
+    }
+    ASSERT_EQ(all_uids.size(), threads_count * uids_per_thread);
+}
+
+// exhausts the generator, so it must be the last test of the generator
+TEST(UidGeneratorTest, Overflow) {
+    const auto first = CU::UidGeneratorT<uint32_t>::GetFromThreadBlock<0x80000000u>();
+    // the block is truncated by the limit
+    const auto second = CU::UidGeneratorT<uint32_t>::GetFromThreadBlock<0x7fffffffu>();
+    ASSERT_EQ(second, first + 0x80000000u);
+
+    EXPECT_THROW(CU::UidGeneratorT<uint32_t>::Get(), std::runtime_error);
+    EXPECT_THROW(CU::UidGeneratorT<uint32_t>::GetFromThreadBlock<64>(), std::runtime_error);
+    EXPECT_THROW(CU::UidGeneratorT<uint32_t>::Get(), std::runtime_error);
+}
+
 int main(int argc, char* argv[]) {
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,421 @@
+// Copyright (c) 2025, Yakov Usoltsev
+// Email: yakovmen62@gmail.com
+//
+// License: MIT
+
+#include <cu/profile-utils.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ProfilerTest, MultithreadAccumulation) {
+    constexpr size_t threads_count = 8;
+    constexpr int64_t activations_count = 1000;
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threads_count; i++) {
+        threads.emplace_back([] {
+            for (int64_t j = 0; j < activations_count; j++) {
+                CU_PROFILE_CHECKBLOCK(accumulation, "multithread_accumulation");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const std::array<std::string, 1> filter = { "multithread_accumulation" };
+    auto results = CU_PROFILE_GET_RESULTS(filter);
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results[filter[0]].m_activations_count, threads_count * activations_count);
+}
+
+TEST(ProfilerTest, ResultsOfRunningThread) {
+    std::atomic<bool> is_stored = false;
+    std::atomic<bool> is_checked = false;
+
+    std::thread thread([&] {
+        {
+            CU_PROFILE_CHECKBLOCK(running, "running_thread");
+        }
+        is_stored = true;
+        while (!is_checked) {
+            std::this_thread::yield();
+        }
+    });
+
+    while (!is_stored) {
+        std::this_thread::yield();
+    }
+
+    const std::array<std::string, 1> filter = { "running_thread" };
+    auto results = CU_PROFILE_GET_RESULTS(filter);
+    is_checked = true;
+    thread.join();
+
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results[filter[0]].m_activations_count, 1);
+}
+
+TEST(ProfilerTest, KeyedTimers) {
+    for (int i = 0; i < 10; i++) {
+        CU_PROFILE_CHECKBLOCK(keyed, "keyed_timer_" + std::to_string(i % 2));
+    }
+
+    const std::array<std::string, 2> filter = { "keyed_timer_0", "keyed_timer_1" };
+    auto results = CU_PROFILE_GET_RESULTS(filter);
+    ASSERT_EQ(results.size(), 2);
+    EXPECT_EQ(results[filter[0]].m_activations_count, 5);
+    EXPECT_EQ(results[filter[1]].m_activations_count, 5);
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+    CU::TimerResult first, second;
+    first.m_histogram = std::make_unique<CU::LatencyHistogram>();
+    second.m_histogram = std::make_unique<CU::LatencyHistogram>();
+
+    for (int64_t duration = 1; duration <= 10000; duration++) {
+        (duration % 2 ? first : second).StoreDuration(duration);
+    }
+    first.Merge(second);
+
+    constexpr double max_relative_error = 1.0 / CU::LatencyHistogram::SUB_BUCKETS_COUNT;
+    for (double percentile : { 50.0, 90.0, 99.0, 99.9 }) {
+        const double expected = percentile * 100.0;
+        const auto actual = double(first.GetPercentileNS(percentile));
+        EXPECT_GE(actual, expected);
+        EXPECT_LE(actual, expected * (1.0 + max_relative_error));
+    }
+    EXPECT_EQ(first.GetPercentileNS(100.0), 10000);
+}
+
+TEST(ProfilerClockTest, Calibration) {
+    ASSERT_TRUE(CU::ProfilerClock::Setup(CU::ProfilerClockSource::AUTO));
+    ASSERT_EQ(CU::ProfilerClock::Setup(CU::ProfilerClockSource::TSC), CU::ProfilerClock::IsTscUsed());
+
+    constexpr int64_t sleep_duration_ns = 10'000'000;
+    const auto start_ticks = CU::ProfilerClock::Now();
+    std::this_thread::sleep_for(std::chrono::nanoseconds(sleep_duration_ns));
+    const auto elapsed_ns = CU::ProfilerClock::ToNanoseconds(CU::ProfilerClock::Now() - start_ticks);
+
+    EXPECT_GE(elapsed_ns, sleep_duration_ns * 9 / 10);
+    EXPECT_LE(elapsed_ns, sleep_duration_ns * 10);
+
+    ASSERT_TRUE(CU::ProfilerClock::Setup(CU::ProfilerClockSource::STEADY_CLOCK));
+    ASSERT_FALSE(CU::ProfilerClock::IsTscUsed());
+}
+
+static void call_tree_child() {
+    CU_PROFILE_CHECKBLOCK(child);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+}
+
+TEST(ProfilerTest, CallTree) {
+    {
+        CU_PROFILE_CHECKBLOCK(call_tree_parent);
+        for (int i = 0; i < 3; i++) {
+            call_tree_child();
+        }
+    }
+
+    const auto call_tree = CU::ProfilerAggregator::GetCallTree();
+    const auto& root = call_tree.GetNode(CU::CallTree::ROOT_NODE);
+
+    const auto parent_it = std::find_if(root.m_children.begin(), root.m_children.end(), [&](auto node) {
+        return CU::ProfilerAggregator::GetTimerName(call_tree.GetNode(node).m_timer_id).starts_with("call_tree_parent");
+        });
+    ASSERT_NE(parent_it, root.m_children.end());
+
+    const auto& parent = call_tree.GetNode(*parent_it);
+    ASSERT_EQ(parent.m_children.size(), 1);
+    const auto& child = call_tree.GetNode(parent.m_children[0]);
+    EXPECT_EQ(child.m_result.m_activations_count, 3);
+    EXPECT_EQ(parent.m_children_duration_ns, child.m_result.m_total_duration_ns);
+    EXPECT_EQ(parent.GetExclusiveNS(), parent.m_result.m_total_duration_ns - child.m_result.m_total_duration_ns);
+
+    std::stringstream collapsed_stacks;
+    CU_PROFILE_WRITE_CALL_TREE(collapsed_stacks);
+    EXPECT_NE(collapsed_stacks.str().find("call_tree_parent: "), std::string::npos);
+    EXPECT_NE(collapsed_stacks.str().find(";child: "), std::string::npos);
+}
+
+TEST(TraceBufferTest, KeepsLatestEvents) {
+    constexpr size_t capacity = 4;
+    CU::TraceBuffer trace_buffer(capacity, 0);
+    for (int64_t i = 0; i < 10; i++) {
+        trace_buffer.Push(CU::TimerId(i), i, i + 1);
+    }
+
+    std::vector<CU::TraceEvent> events;
+    trace_buffer.CopyTo(events);
+    ASSERT_EQ(events.size(), capacity);
+    for (size_t i = 0; i < capacity; i++) {
+        EXPECT_EQ(events[i].m_start_ticks, int64_t(10 - capacity + i));
+        EXPECT_EQ(events[i].m_stop_ticks, events[i].m_start_ticks + 1);
+    }
+}
+
+TEST(ProfilerTest, Trace) {
+    std::thread([] {
+        CU_PROFILE_CHECKBLOCK(traced, "traced \"block\"");
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }).join();
+
+    std::stringstream trace;
+    CU_PROFILE_WRITE_TRACE(trace);
+    EXPECT_TRUE(trace.str().starts_with("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+    EXPECT_NE(trace.str().find("{\"name\":\"traced \\\"block\\\": "), std::string::npos);
+    EXPECT_NE(trace.str().find("\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(trace.str().find("\"name\":\"thread_name\""), std::string::npos);
+}
+
+TEST(ProfilerTest, TraceOfFinishedThreads) {
+    // the events of finished threads share one ring of the trace buffer capacity (1024)
+    for (int thread = 0; thread < 20; thread++) {
+        std::thread([] {
+            for (int i = 0; i < 100; i++) {
+                CU_PROFILE_CHECKBLOCK(finished_traced);
+            }
+            }).join();
+    }
+
+    auto count_events = [] {
+        std::stringstream trace;
+        CU_PROFILE_WRITE_TRACE(trace);
+        const auto text = trace.str();
+        size_t count = 0;
+        for (auto pos = text.find("\"finished_traced: "); pos != std::string::npos;
+             pos = text.find("\"finished_traced: ", pos + 1)) {
+            count++;
+        }
+        return count;
+    };
+
+    const auto events_count = count_events();
+    EXPECT_GT(events_count, 0);
+    EXPECT_LE(events_count, 1024);
+    // the events of finished threads are released after the writing
+    EXPECT_EQ(count_events(), 0);
+}
+
+TEST(StreamProfilerSinkTest, Formats) {
+    CU::TimersResults results;
+    for (int64_t duration_ns : { 10, 20, 30 }) {
+        results["quoted \"timer\""].StoreDuration(duration_ns);
+    }
+
+    std::stringstream csv;
+    CU::StreamProfilerSink csv_sink(csv, CU::ProfilerReportFormat::CSV);
+    csv_sink.Write(CU::ProfilerReportKind::INTERVAL, 1000, results);
+    csv_sink.Write(CU::ProfilerReportKind::TOTAL, 2000, results);
+    EXPECT_EQ(csv.str(),
+        "report,interval_ns,timer,count,timed_count,total_ns,min_ns,max_ns,avg_ns,p50_ns,p90_ns,p99_ns,p99.9_ns,"
+        "ipc,cache_misses_per_call,branch_misses_per_call\n"
+        "interval,1000,\"quoted \"\"timer\"\"\",3,3,60,10,30,20,,,,,,,\n"
+        "total,2000,\"quoted \"\"timer\"\"\",3,3,60,10,30,20,,,,,,,\n");
+
+    std::stringstream json;
+    CU::StreamProfilerSink json_sink(json, CU::ProfilerReportFormat::JSON);
+    json_sink.Write(CU::ProfilerReportKind::TOTAL, 2000, results);
+    EXPECT_EQ(json.str(),
+        "{\"report\":\"total\",\"interval_ns\":2000,\"timers\":[{\"name\":\"quoted \\\"timer\\\"\","
+        "\"count\":3,\"timed_count\":3,\"total_ns\":60,\"min_ns\":10,\"max_ns\":30,\"avg_ns\":20}]}\n");
+}
+
+TEST(StreamProfilerSinkTest, UntimedActivationsOnly) {
+    // all activations of the interval were skipped by sampling
+    CU::TimersResults results;
+    results["sampled"].StoreUntimedActivations(5);
+
+    std::stringstream text;
+    CU::StreamProfilerSink text_sink(text, CU::ProfilerReportFormat::TEXT);
+    text_sink.Write(CU::ProfilerReportKind::INTERVAL, 1000, results);
+    EXPECT_EQ(text.str(),
+        "Profiler results for the last 1.000000 us.\n"
+        "sampled:\n"
+        "\tactivations count = 5\n"
+        "\ttimed activations count = 0\n\n");
+
+    std::stringstream csv;
+    CU::StreamProfilerSink csv_sink(csv, CU::ProfilerReportFormat::CSV);
+    csv_sink.Write(CU::ProfilerReportKind::INTERVAL, 1000, results);
+    EXPECT_TRUE(csv.str().ends_with("\ninterval,1000,\"sampled\",5,0,,,,,,,,,,,\n"));
+
+    std::stringstream json;
+    CU::StreamProfilerSink json_sink(json, CU::ProfilerReportFormat::JSON);
+    json_sink.Write(CU::ProfilerReportKind::INTERVAL, 1000, results);
+    EXPECT_EQ(json.str(),
+        "{\"report\":\"interval\",\"interval_ns\":1000,\"timers\":[{\"name\":\"sampled\","
+        "\"count\":5,\"timed_count\":0}]}\n");
+}
+
+TEST(FileProfilerSinkTest, ReportsOpenFailure) {
+    CU::FileProfilerSink sink(std::filesystem::temp_directory_path() / "missing-directory" / "report.csv",
+                              CU::ProfilerReportFormat::CSV);
+    EXPECT_FALSE(sink.IsOpen());
+    // the reports are skipped
+    sink.Write(CU::ProfilerReportKind::TOTAL, 1000, {});
+}
+
+// collects names of timers from the interval reports
+class IntervalTimersSink : public CU::ProfilerSink {
+public:
+    void Write(CU::ProfilerReportKind kind, int64_t, const CU::TimersResults& results) override {
+        if (CU::ProfilerReportKind::INTERVAL != kind)
+            return;
+
+        std::scoped_lock _(m_lock);
+        for (const auto& [timer_name, timer_result] : results) {
+            m_counts[timer_name] += timer_result.m_activations_count;
+        }
+    }
+
+    int64_t GetCount(const std::string& timer_prefix) {
+        std::scoped_lock _(m_lock);
+        int64_t count = 0;
+        for (const auto& [timer_name, timer_count] : m_counts) {
+            if (timer_name.starts_with(timer_prefix))
+                count += timer_count;
+        }
+        return count;
+    }
+
+private:
+    std::mutex m_lock;
+    std::unordered_map<std::string, int64_t> m_counts;
+};
+
+static const auto interval_timers_sink = std::make_shared<IntervalTimersSink>();
+
+TEST(ProfilerTest, IntervalReports) {
+    constexpr int activations_count = 5;
+    for (int i = 0; i < activations_count; i++) {
+        CU_PROFILE_CHECKBLOCK(interval_reported);
+    }
+
+    for (int i = 0; i < 100 && interval_timers_sink->GetCount("interval_reported: ") < activations_count; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(interval_timers_sink->GetCount("interval_reported: "), activations_count);
+
+    // the reported results remain in the total results
+    const auto results = CU_PROFILE_GET_RESULTS();
+    const auto it = std::find_if(results.begin(), results.end(), [](const auto& result) {
+        return result.first.starts_with("interval_reported: ");
+        });
+    ASSERT_NE(it, results.end());
+    EXPECT_EQ(it->second.m_activations_count, activations_count);
+}
+
+TEST(ProfilerTest, HardwareCounters) {
+    volatile int64_t sum = 0;
+    {
+        CU_PROFILE_CHECKBLOCK(counted);
+        for (int64_t i = 0; i < 100000; i++) {
+            sum = sum + i;
+        }
+    }
+
+    const auto results = CU_PROFILE_GET_RESULTS();
+    const auto it = std::find_if(results.begin(), results.end(), [](const auto& result) {
+        return result.first.starts_with("counted: ");
+        });
+    ASSERT_NE(it, results.end());
+
+    // perf events may be unavailable (e.g. in containers), then only durations are collected
+    if (CU::HardwareCountersReader{}.IsAvailable()) {
+        ASSERT_TRUE(it->second.HasHardwareCounters());
+        EXPECT_GT(it->second.m_hardware_counters.m_instructions, 100000);
+        EXPECT_GT(it->second.GetIPC(), 0.0);
+    }
+    else {
+        EXPECT_FALSE(it->second.HasHardwareCounters());
+    }
+    EXPECT_EQ(it->second.m_activations_count, 1);
+}
+
+TEST(ProfilerTest, SampledTimers) {
+    constexpr int threads_count = 4;
+    constexpr int activations_count = 1001;
+    constexpr int sampling_rate = 10;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threads_count; i++) {
+        threads.emplace_back([] {
+            for (int j = 0; j < activations_count; j++) {
+                CU_PROFILE_CHECKBLOCK_SAMPLED(sampling_rate, sampled);
+            }
+            });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // activations of the running thread are counted too
+    for (int j = 0; j < activations_count; j++) {
+        CU_PROFILE_CHECKBLOCK_SAMPLED(sampling_rate, running_sampled);
+    }
+
+    const auto results = CU_PROFILE_GET_RESULTS();
+    for (const auto& [prefix, expected_count] : { std::pair{ "sampled: ", threads_count * activations_count },
+                                                  std::pair{ "running_sampled: ", activations_count } }) {
+        const auto it = std::find_if(results.begin(), results.end(), [prefix](const auto& result) {
+            return result.first.starts_with(prefix);
+            });
+        ASSERT_NE(it, results.end());
+
+        // the first activation is timed, then every sampling_rate-th
+        const int timed_count = expected_count / activations_count * ((activations_count - 1) / sampling_rate + 1);
+        EXPECT_EQ(it->second.m_activations_count, expected_count);
+        EXPECT_EQ(it->second.GetTimedActivationsCount(), timed_count);
+        EXPECT_GE(it->second.GetEstimatedTotalNS(), it->second.m_total_duration_ns);
+    }
+}
+
+TEST(ProfilerTest, ResultsSnapshot) {
+    for (const char* key : { "snapshot_b", "snapshot_a", "snapshot_c", "snapshot_a" }) {
+        CU_PROFILE_CHECKBLOCK(snapshot, key);
+    }
+
+    const auto snapshot = CU::ProfilerAggregator::GetResultsSnapshot();
+
+    std::vector<std::string> visited_names;
+    int64_t visited_count = 0;
+    snapshot.Visit("snapshot_", [&](std::string_view timer_name, const CU::TimerResult& result) {
+        visited_names.emplace_back(timer_name.substr(0, timer_name.find(':')));
+        visited_count += result.m_activations_count;
+        });
+    EXPECT_EQ(visited_names, std::vector<std::string>({ "snapshot_a", "snapshot_b", "snapshot_c" }));
+    EXPECT_EQ(visited_count, 4);
+
+    const auto* result = snapshot.FindFirst("snapshot_a: ");
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(result->m_activations_count, 2);
+    EXPECT_EQ(snapshot.FindFirst("snapshot_d"), nullptr);
+
+    // the snapshot doesn't lock the profiler, timers are registered while it exists
+    {
+        CU_PROFILE_CHECKBLOCK(snapshot_d);
+    }
+    EXPECT_EQ(snapshot.FindFirst("snapshot_d"), nullptr);
+    EXPECT_EQ(CU_PROFILE_GET_RESULTS(std::vector<std::string>{ "snapshot_d" }).size(), 1);
+}
+
+int main(int argc, char* argv[]) {
+    USE_CU_PROFILE_CONFIG({
+        .m_collect_call_tree = true,
+        .m_trace_buffer_capacity = 1024,
+        .m_sinks = { std::make_shared<CU::StreamProfilerSink>(std::cout), interval_timers_sink },
+        .m_collect_hardware_counters = true,
+        .m_report_interval = std::chrono::milliseconds(20) });
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
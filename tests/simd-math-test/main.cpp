@@ -0,0 +1,350 @@
+// Copyright (c) 2025, Yakov Usoltsev
+// Email: yakovmen62@gmail.com
+//
+// License: MIT
+
+#include <cu/simd-math-utils.hpp>
+#include <cu/file-utils.hpp>
+#include <cu/math-utils.hpp>
+#include <cu/test-utils.hpp>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <limits>
+#include <filesystem>
+
+// sets of the kernels units except DEF
+#if defined(CU_ARCH_X86_64)
+static const std::vector<CU::InstructionsSet> TEST_INSETS = { CU::E_INSET_SSE4_2, CU::E_INSET_AVX2, CU::E_INSET_AVX512F };
+#else
+static const std::vector<CU::InstructionsSet> TEST_INSETS = {};
+#endif // CU_ARCH_*
+
+static constexpr float INF = std::numeric_limits<float>::infinity();
+static constexpr float NaN = std::numeric_limits<float>::quiet_NaN();
+
+// the sizes cover empty arrays, partial vectors and blocks of vectors of every unit
+static const int64_t TEST_SIZES[] = { 0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 63, 64, 65, 100, 1000, 10007 };
+
+// calls check(function, inset name) for the DEF variant and every variant supported by the current CPU
+template<typename Function, typename Check>
+static void for_each_variant(const CU::SimdFunction<Function>& function, Check check) {
+    check(function.Get(CU::DEFAULT_INSET), "DEF");
+    for (const auto inset : TEST_INSETS) {
+        const auto variant = function.Get(inset);
+        ASSERT_EQ(variant != nullptr, CU::is_inset_supported(inset)) << CU::get_inset_name(inset);
+        if (variant)
+            check(variant, CU::get_inset_name(inset));
+    }
+    check(function.Get(), "entry point");
+}
+
+static std::vector<float> make_random_values(int64_t size, float min_value, float max_value, uint64_t seed = 42) {
+    std::mt19937_64 generator{ seed };
+    std::uniform_real_distribution<float> distribution{ min_value, max_value };
+    std::vector<float> values(size);
+    std::generate(values.begin(), values.end(), [&]() { return distribution(generator); });
+    return values;
+}
+
+TEST(SimdMathTest, Dispatch) {
+    ASSERT_EQ(CU::Math::sum.Get(CU::DEFAULT_INSET), &CU::Math::sum_def);
+    ASSERT_TRUE(CU::DEFAULT_INSET == CU::Math::exp.GetInset() || CU::is_inset_supported(CU::Math::exp.GetInset()));
+
+#if defined(CU_ARCH_X86_64)
+    if (CU::is_inset_supported(CU::E_INSET_AVX512F)) {
+        ASSERT_EQ(CU::Math::tanh.GetInset(), CU::E_INSET_AVX512F);
+    } else if (CU::is_inset_supported(CU::E_INSET_AVX2)) {
+        ASSERT_EQ(CU::Math::tanh.GetInset(), CU::E_INSET_AVX2);
+    }
+#endif // CU_ARCH_X86_64
+
+    const std::vector<float> values{ 1.0f, 2.0f, 3.0f };
+    ASSERT_EQ(CU::Math::sum(values.data(), int64_t(values.size())), 6.0f);
+    ASSERT_EQ(CU::Math::argmax(values.data(), int64_t(values.size())), 2);
+}
+
+TEST(SimdMathTest, Reductions) {
+    const auto values = make_random_values(10007, -100.0f, 100.0f);
+    const auto other_values = make_random_values(10007, -1.0f, 1.0f, 7);
+
+    for (const auto size : TEST_SIZES) {
+        double expected_sum = 0.0;
+        double expected_dot = 0.0;
+        double sum_of_abs = 0.0;
+        for (int64_t i = 0; i < size; i++) {
+            expected_sum += values[i];
+            expected_dot += double(values[i]) * other_values[i];
+            sum_of_abs += std::abs(values[i]);
+        }
+        const auto begin = values.begin();
+        const auto expected_min = size ? *std::min_element(begin, begin + size) : INF;
+        const auto expected_max = size ? *std::max_element(begin, begin + size) : -INF;
+        const auto expected_argmax = size ? std::max_element(begin, begin + size) - begin : -1;
+
+        // the error of the sum is bounded by the sum of the absolute values
+        const auto tolerance = 1.0e-5 * sum_of_abs;
+        for_each_variant(CU::Math::sum, [&](auto function, const char* name) {
+            EXPECT_NEAR(function(values.data(), size), expected_sum, tolerance) << name << " " << size;
+        });
+        for_each_variant(CU::Math::dot, [&](auto function, const char* name) {
+            EXPECT_NEAR(function(values.data(), other_values.data(), size), expected_dot, tolerance) << name << " " << size;
+        });
+        for_each_variant(CU::Math::min, [&](auto function, const char* name) {
+            EXPECT_EQ(function(values.data(), size), expected_min) << name << " " << size;
+        });
+        for_each_variant(CU::Math::max, [&](auto function, const char* name) {
+            EXPECT_EQ(function(values.data(), size), expected_max) << name << " " << size;
+        });
+        for_each_variant(CU::Math::argmax, [&](auto function, const char* name) {
+            EXPECT_EQ(function(values.data(), size), expected_argmax) << name << " " << size;
+        });
+    }
+}
+
+TEST(SimdMathTest, ReductionsSpecialValues) {
+    // NaN values are skipped, the first maximum is found
+    std::vector<float> values(37, 1.0f);
+    values[0] = NaN;
+    values[5] = 3.0f;
+    values[20] = 3.0f;
+    values[36] = NaN;
+    values[30] = -2.0f;
+    const auto size = int64_t(values.size());
+
+    for_each_variant(CU::Math::min, [&](auto function, const char* name) {
+        EXPECT_EQ(function(values.data(), size), -2.0f) << name;
+    });
+    for_each_variant(CU::Math::max, [&](auto function, const char* name) {
+        EXPECT_EQ(function(values.data(), size), 3.0f) << name;
+    });
+    for_each_variant(CU::Math::argmax, [&](auto function, const char* name) {
+        EXPECT_EQ(function(values.data(), size), 5) << name;
+    });
+
+    const std::vector<float> nan_values(20, NaN);
+    for_each_variant(CU::Math::argmax, [&](auto function, const char* name) {
+        EXPECT_EQ(function(nan_values.data(), int64_t(nan_values.size())), -1) << name;
+    });
+    for_each_variant(CU::Math::max, [&](auto function, const char* name) {
+        EXPECT_EQ(function(nan_values.data(), int64_t(nan_values.size())), -INF) << name;
+    });
+}
+
+TEST(SimdMathTest, Axpy) {
+    const auto x = make_random_values(10007, -10.0f, 10.0f);
+    const auto initial_y = make_random_values(10008, -10.0f, 10.0f, 7);
+
+    for (const auto size : TEST_SIZES) {
+        for_each_variant(CU::Math::axpy, [&](auto function, const char* name) {
+            auto y = initial_y;
+            function(0.75f, x.data(), y.data(), size);
+            for (int64_t i = 0; i < size; i++) {
+                ASSERT_NEAR(y[i], 0.75f * x[i] + initial_y[i], 1.0e-5f) << name << " " << i;
+            }
+            // the memory after the arrays isn't written
+            ASSERT_EQ(y[size], initial_y[size]) << name;
+        });
+    }
+}
+
+// checks the kernel against the reference in double, the values are compared with the relative error
+// or with the absolute error for the results near zero
+template<typename Function, typename Reference>
+static void check_approximation(const CU::SimdFunction<Function>& function, const std::vector<float>& values,
+                                Reference reference, float absolute_epsilon, float relative_epsilon) {
+    for (const auto size : TEST_SIZES) {
+        for_each_variant(function, [&](auto variant, const char* name) {
+            std::vector<float> results(size + 1, 42.0f);
+            variant(values.data(), size, results.data());
+            for (int64_t i = 0; i < size; i++) {
+                const auto expected = float(reference(double(values[i])));
+                if (std::isnan(expected)) {
+                    ASSERT_TRUE(std::isnan(results[i])) << name << " " << values[i];
+                } else if (std::isinf(expected)) {
+                    ASSERT_EQ(results[i], expected) << name << " " << values[i];
+                } else {
+                    ASSERT_TRUE(CU::is_equal(results[i], expected, absolute_epsilon, relative_epsilon))
+                        << name << " " << values[i] << ": " << results[i] << " != " << expected;
+                }
+            }
+            ASSERT_EQ(results[size], 42.0f) << name;
+        });
+    }
+
+    // in place
+    auto results = values;
+    function(results.data(), int64_t(results.size()), results.data());
+    for (size_t i = 0; i < values.size(); i++) {
+        ASSERT_TRUE(CU::is_equal(results[i], float(reference(double(values[i]))), absolute_epsilon, relative_epsilon) ||
+                    std::isnan(results[i]) || std::isinf(results[i])) << values[i];
+    }
+}
+
+TEST(SimdMathTest, Exp) {
+    auto values = make_random_values(10007, -100.0f, 100.0f);
+    const float special_values[] = { 0.0f, -0.0f, 1.0f, -1.0f, 88.7f, 88.8f, -87.3f, -103.0f, -104.5f, INF, -INF, NaN };
+    std::copy(std::begin(special_values), std::end(special_values), values.begin() + 3);
+
+    // the denormal results are compared with the absolute error
+    check_approximation(CU::Math::exp, values, [](double x) { return std::exp(x); }, 1.0e-44f, 1.0e-6f);
+}
+
+TEST(SimdMathTest, Log) {
+    auto values = make_random_values(10007, 0.0f, 10.0f);
+    auto wide_values = make_random_values(5000, -30.0f, 30.0f, 7);
+    std::transform(wide_values.begin(), wide_values.end(), values.begin() + 5000,
+        [](float x) { return std::exp2(x); });
+    const float special_values[] = { 1.0f, 0.0f, -0.0f, -1.0f, 1.0e-40f, std::numeric_limits<float>::denorm_min(),
+                                     std::numeric_limits<float>::max(), 0.99999994f, 1.0000001f, INF, -INF, NaN };
+    std::copy(std::begin(special_values), std::end(special_values), values.begin() + 3);
+
+    check_approximation(CU::Math::log, values, [](double x) { return std::log(x); }, 1.0e-7f, 1.0e-6f);
+}
+
+TEST(SimdMathTest, Tanh) {
+    auto values = make_random_values(10007, -5.0f, 5.0f);
+    const float special_values[] = { 0.0f, -0.0f, 0.625f, -0.625f, 0.62499994f, 1.0e-30f, 9.0f, -20.0f, 100.0f, INF, -INF, NaN };
+    std::copy(std::begin(special_values), std::end(special_values), values.begin() + 3);
+
+    check_approximation(CU::Math::tanh, values, [](double x) { return std::tanh(x); }, 1.0e-7f, 1.0e-6f);
+}
+
+TEST(SimdMathTest, IsEqual) {
+    const auto lhs = make_random_values(10007, -10.0f, 10.0f);
+
+    for (const auto size : TEST_SIZES) {
+        for_each_variant(CU::Math::is_equal, [&](auto function, const char* name) {
+            auto rhs = lhs;
+            // the deltas are compared with "less", as in CU::is_equal, so zero epsilons make every pair different
+            ASSERT_TRUE(function(lhs.data(), rhs.data(), size, 1.0e-7f, 0.0f)) << name;
+            ASSERT_EQ(function(lhs.data(), rhs.data(), size, 0.0f, 0.0f), size == 0) << name;
+
+            // one value at the end, so the tail is checked too
+            if (size) {
+                rhs[size - 1] += 1.0e-3f;
+                ASSERT_FALSE(function(lhs.data(), rhs.data(), size, 1.0e-4f, 1.0e-5f)) << name << " " << size;
+                ASSERT_TRUE(function(lhs.data(), rhs.data(), size, 1.0e-2f, 0.0f)) << name << " " << size;
+                const bool expected = CU::is_equal(lhs[size - 1], rhs[size - 1], 0.0f, 1.0e-3f);
+                ASSERT_EQ(function(lhs.data(), rhs.data(), size, 0.0f, 1.0e-3f), expected) << name << " " << size;
+            }
+        });
+    }
+
+    const std::vector<float> nan_values{ 1.0f, NaN };
+    for_each_variant(CU::Math::is_equal, [&](auto function, const char* name) {
+        EXPECT_FALSE(function(nan_values.data(), nan_values.data(), 2, 1.0f, 1.0f)) << name;
+    });
+}
+
+#if defined(ENABLE_CU_TEST_UTILS)
+// Conformance and performance tests of the variants, the data is generated by generate_test_data.
+// The reductions write their results into results[0], so they have the signature of CU::TestFunction.
+#define SIMD_MATH_TEST_FUNCTIONS(set) \
+    static void sum_test_##set(const float* values, int64_t size, float* results) { \
+        results[0] = CU::Math::sum_##set(values, size); \
+    } \
+    static void dot_test_##set(const float* values, int64_t size, float* results) { \
+        results[0] = CU::Math::dot_##set(values, values, size); \
+    } \
+    static void argmax_test_##set(const float* values, int64_t size, float* results) { \
+        results[0] = CU::Math::min_##set(values, size); \
+        results[1] = CU::Math::max_##set(values, size); \
+        results[2] = float(CU::Math::argmax_##set(values, size)); \
+    } \
+    static void axpy_test_##set(const float* values, int64_t size, float* results) { \
+        std::copy(values, values + size, results); \
+        CU::Math::axpy_##set(0.5f, values, results, size); \
+    } \
+    static void is_equal_test_##set(const float* values, int64_t size, float* results) { \
+        results[0] = float(CU::Math::is_equal_##set(values, values, size, 1.0e-7f, 0.0f)); \
+    }
+
+#if defined(CU_ARCH_X86_64)
+#  define SIMD_MATH_TEST_SETS (def, sse4_2, avx2, avx512)
+SIMD_MATH_TEST_FUNCTIONS(def)
+SIMD_MATH_TEST_FUNCTIONS(sse4_2)
+SIMD_MATH_TEST_FUNCTIONS(avx2)
+SIMD_MATH_TEST_FUNCTIONS(avx512)
+#else
+#  define SIMD_MATH_TEST_SETS (def)
+SIMD_MATH_TEST_FUNCTIONS(def)
+#endif // CU_ARCH_X86_64
+
+static const std::filesystem::path TEST_DATA_PATH = std::filesystem::temp_directory_path() / "cu-simd-math-test";
+
+// the reductions use small integers, so their results are exact in any order of additions
+static bool generate_test_data() {
+    std::filesystem::create_directories(TEST_DATA_PATH);
+    constexpr int64_t SIZE = 1 << 20;
+
+    std::mt19937_64 generator{ 42 };
+    std::uniform_int_distribution<int> distribution{ -2, 2 };
+    std::vector<float> values(SIZE);
+    std::generate(values.begin(), values.end(), [&]() { return float(distribution(generator)); });
+    values[SIZE / 3] = 3.0f;
+    values[SIZE / 2] = 3.0f;
+
+    const auto sum = std::accumulate(values.begin(), values.end(), 0.0f);
+    const auto dot = std::inner_product(values.begin(), values.end(), values.begin(), 0.0f);
+    std::vector<float> axpy(values);
+    std::transform(axpy.begin(), axpy.end(), axpy.begin(), [](float x) { return 1.5f * x; });
+
+    const auto exp_values = make_random_values(SIZE, -80.0f, 80.0f);
+    const auto log_values = make_random_values(SIZE, 1.0e-3f, 1.0e3f);
+    const auto tanh_values = make_random_values(SIZE, -10.0f, 10.0f);
+    const auto control_values = [](const std::vector<float>& inputs, auto reference) {
+        std::vector<float> result(inputs.size());
+        std::transform(inputs.begin(), inputs.end(), result.begin(), [reference](float x) { return float(reference(x)); });
+        return result;
+    };
+
+    return CU::save_data_to_file(TEST_DATA_PATH / "values.bin", values) &&
+           CU::save_data_to_file(TEST_DATA_PATH / "sum.bin", std::vector<float>{ sum }) &&
+           CU::save_data_to_file(TEST_DATA_PATH / "dot.bin", std::vector<float>{ dot }) &&
+           CU::save_data_to_file(TEST_DATA_PATH / "argmax.bin", std::vector<float>{ -2.0f, 3.0f, float(SIZE / 3) }) &&
+           CU::save_data_to_file(TEST_DATA_PATH / "axpy.bin", axpy) &&
+           CU::save_data_to_file(TEST_DATA_PATH / "is_equal.bin", std::vector<float>{ 1.0f }) &&
+           CU::save_data_to_file(TEST_DATA_PATH / "exp-values.bin", exp_values) &&
+           CU::save_data_to_file(TEST_DATA_PATH / "exp.bin", control_values(exp_values, [](double x) { return std::exp(x); })) &&
+           CU::save_data_to_file(TEST_DATA_PATH / "log-values.bin", log_values) &&
+           CU::save_data_to_file(TEST_DATA_PATH / "log.bin", control_values(log_values, [](double x) { return std::log(x); })) &&
+           CU::save_data_to_file(TEST_DATA_PATH / "tanh-values.bin", tanh_values) &&
+           CU::save_data_to_file(TEST_DATA_PATH / "tanh.bin", control_values(tanh_values, [](double x) { return std::tanh(x); }));
+}
+
+CU_CONFORMANCE_TEST_SIMD(Sum, TEST_DATA_PATH, "values.bin", "sum.bin", sum_test, SIMD_MATH_TEST_SETS)
+CU_CONFORMANCE_TEST_SIMD(Dot, TEST_DATA_PATH, "values.bin", "dot.bin", dot_test, SIMD_MATH_TEST_SETS)
+CU_CONFORMANCE_TEST_SIMD(Argmax, TEST_DATA_PATH, "values.bin", "argmax.bin", argmax_test, SIMD_MATH_TEST_SETS)
+CU_CONFORMANCE_TEST_SIMD(Axpy, TEST_DATA_PATH, "values.bin", "axpy.bin", axpy_test, SIMD_MATH_TEST_SETS)
+CU_CONFORMANCE_TEST_SIMD(IsEqual, TEST_DATA_PATH, "values.bin", "is_equal.bin", is_equal_test, SIMD_MATH_TEST_SETS)
+CU_CONFORMANCE_TEST_SIMD(Exp, TEST_DATA_PATH, "exp-values.bin", "exp.bin", CU::Math::exp, SIMD_MATH_TEST_SETS)
+CU_CONFORMANCE_TEST_SIMD(Log, TEST_DATA_PATH, "log-values.bin", "log.bin", CU::Math::log, SIMD_MATH_TEST_SETS)
+CU_CONFORMANCE_TEST_SIMD(Tanh, TEST_DATA_PATH, "tanh-values.bin", "tanh.bin", CU::Math::tanh, SIMD_MATH_TEST_SETS)
+
+CU_PERFORMANCE_TEST_SIMD(Sum, TEST_DATA_PATH, "values.bin", sum_test, SIMD_MATH_TEST_SETS)
+CU_PERFORMANCE_TEST_SIMD(Dot, TEST_DATA_PATH, "values.bin", dot_test, SIMD_MATH_TEST_SETS)
+CU_PERFORMANCE_TEST_SIMD(Argmax, TEST_DATA_PATH, "values.bin", argmax_test, SIMD_MATH_TEST_SETS)
+CU_PERFORMANCE_TEST_SIMD(Axpy, TEST_DATA_PATH, "values.bin", axpy_test, SIMD_MATH_TEST_SETS)
+CU_PERFORMANCE_TEST_SIMD(IsEqual, TEST_DATA_PATH, "values.bin", is_equal_test, SIMD_MATH_TEST_SETS)
+CU_PERFORMANCE_TEST_SIMD(Exp, TEST_DATA_PATH, "exp-values.bin", CU::Math::exp, SIMD_MATH_TEST_SETS)
+CU_PERFORMANCE_TEST_SIMD(Log, TEST_DATA_PATH, "log-values.bin", CU::Math::log, SIMD_MATH_TEST_SETS)
+CU_PERFORMANCE_TEST_SIMD(Tanh, TEST_DATA_PATH, "tanh-values.bin", CU::Math::tanh, SIMD_MATH_TEST_SETS)
+#endif // ENABLE_CU_TEST_UTILS
+
+int main(int argc, char* argv[]) {
+#if defined(ENABLE_CU_TEST_UTILS)
+    if (!generate_test_data()) {
+        std::cout << "ERROR: failed to generate the test data" << std::endl;
+        return 1;
+    }
+#endif // ENABLE_CU_TEST_UTILS
+
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
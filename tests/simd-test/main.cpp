@@ -0,0 +1,199 @@
+// Copyright (c) 2025, Yakov Usoltsev
+// Email: yakovmen62@gmail.com
+//
+// License: MIT
+
+#include "simd_sum.hpp"
+#include "simd_vector.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <random>
+#include <cstring>
+
+// sets of the test units except DEF and profiles
+#if defined(CU_ARCH_X86_64)
+static const CU::InstructionsSet TEST_INSETS[] = { CU::E_INSET_SSE4_2, CU::E_INSET_AVX2, CU::E_INSET_AVX512F };
+#elif defined(CU_ARCH_AARCH64)
+static const CU::InstructionsSet TEST_INSETS[] = { CU::E_INSET_NEON, CU::E_INSET_SVE, CU::E_INSET_SVE2 };
+#endif // CU_ARCH_*
+
+TEST(SimdFunctionTest, Dispatch) {
+    std::vector<float> values(1000);
+    std::iota(values.begin(), values.end(), 1.0f);
+    const float expected = 1000.0f * 1001.0f / 2.0f;
+
+    // the entry point calls the best supported variant
+    ASSERT_FLOAT_EQ(simd_sum(values.data(), int64_t(values.size())), expected);
+    ASSERT_EQ(simd_sum.Get(), simd_sum.GetProfile() ?
+        simd_sum.Get(*simd_sum.GetProfile()) : simd_sum.Get(simd_sum.GetInset()));
+    ASSERT_TRUE(CU::DEFAULT_INSET == simd_sum.GetInset() || CU::is_inset_supported(simd_sum.GetInset()));
+
+    // variants are available only if they are supported by the current CPU
+    ASSERT_EQ(simd_sum.Get(CU::DEFAULT_INSET), &simd_sum_def);
+    for (const auto inset : TEST_INSETS) {
+        const auto function = simd_sum.Get(inset);
+        ASSERT_EQ(function != nullptr, CU::is_inset_supported(inset)) << CU::get_inset_name(inset);
+        if (function) {
+            ASSERT_FLOAT_EQ(function(values.data(), int64_t(values.size())), expected) << CU::get_inset_name(inset);
+        }
+    }
+
+#if defined(CU_ARCH_X86_64)
+    ASSERT_EQ(simd_sum.Get(CU::E_INSET_AVX), nullptr);
+
+    if (CU::is_inset_supported(CU::E_INSET_AVX2)) {
+        ASSERT_NE(simd_sum.GetInset(), CU::DEFAULT_INSET);
+    }
+#elif defined(CU_ARCH_AARCH64)
+    // sets of other processors aren't compiled
+    ASSERT_EQ(simd_sum.Get(CU::E_INSET_NEON_DOTPROD), nullptr);
+
+    if (CU::is_inset_supported(CU::E_INSET_NEON)) {
+        ASSERT_NE(simd_sum.GetInset(), CU::DEFAULT_INSET);
+    }
+#endif // CU_ARCH_*
+}
+
+TEST(SimdFunctionTest, NoSupportedVariant) {
+    const CU::SimdFunction<int()> function{ std::initializer_list<CU::SimdFunction<int()>::Variant>{} };
+    ASSERT_EQ(function.Get(), nullptr);
+    ASSERT_THROW(function(), std::runtime_error);
+}
+
+#if defined(CU_ARCH_X86_64)
+TEST(SimdFunctionTest, Profiles) {
+    std::vector<float> values(100, 0.5f);
+
+    // the richest supported profile is preferred
+    const CU::InstructionsProfile* profiles[] = {
+        &CU::INSET_PROFILE_AVX512_FP16, &CU::INSET_PROFILE_AVX512_VNNI, &CU::INSET_PROFILE_X86_64_V4 };
+    const CU::InstructionsProfile* expected_profile = nullptr;
+    for (const auto* profile : profiles) {
+        const auto function = simd_sum.Get(*profile);
+        ASSERT_EQ(function != nullptr, CU::is_profile_supported(*profile)) << profile->m_name;
+        if (function) {
+            ASSERT_FLOAT_EQ(function(values.data(), int64_t(values.size())), 50.0f) << profile->m_name;
+            expected_profile = expected_profile ? expected_profile : profile;
+        }
+    }
+    ASSERT_EQ(simd_sum.GetProfile(), expected_profile);
+
+    // profiles are supported only if all their sets are supported
+    ASSERT_EQ(CU::is_profile_supported(CU::INSET_PROFILE_AVX512_VNNI),
+              CU::is_profile_supported(CU::INSET_PROFILE_X86_64_V4) && CU::is_inset_supported(CU::E_INSET_AVX512VNNI));
+    ASSERT_EQ(CU::is_function_can_be_run("simd_sum_avx512_vnni"),
+              CU::is_profile_supported(CU::INSET_PROFILE_AVX512_VNNI));
+    ASSERT_EQ(CU::is_function_can_be_run("simd_sum_x86_64_v4"),
+              CU::is_profile_supported(CU::INSET_PROFILE_X86_64_V4));
+    ASSERT_EQ(CU::get_profile_by_name("AVX512_FP16"), &CU::INSET_PROFILE_AVX512_FP16);
+}
+#endif // CU_ARCH_X86_64
+
+#if defined(CU_ARCH_AARCH64)
+TEST(SimdFunctionTest, AArch64Features) {
+    // Advanced SIMD is the part of the base architecture, SVE2 requires SVE
+    ASSERT_TRUE(CU::is_inset_supported(CU::E_INSET_NEON));
+    if (CU::is_inset_supported(CU::E_INSET_SVE2)) {
+        ASSERT_TRUE(CU::is_inset_supported(CU::E_INSET_SVE));
+    }
+    ASSERT_EQ(CU::is_function_can_be_run("simd_sum_sve"), CU::is_inset_supported(CU::E_INSET_SVE));
+    ASSERT_EQ(CU::get_inset_by_name("SVE2"), CU::InstructionsSet(CU::E_INSET_SVE2));
+}
+#endif // CU_ARCH_AARCH64
+
+template<typename T, typename Function>
+static void check_simd_vector_units(const Function& function,
+    const std::vector<T>& lhs, const std::vector<T>& rhs, const std::vector<int32_t>& indices) {
+    const auto size = int64_t(lhs.size());
+    const T sentinel = T(7);
+    std::vector<T> expected(3 * size + 6, sentinel);
+    function.Get(CU::DEFAULT_INSET)(lhs.data(), rhs.data(), indices.data(), size, expected.data());
+
+    // the scalar vectors of DEF work as plain code, the partial stores don't write after the tail
+    ASSERT_EQ(expected.back(), sentinel);
+    int64_t less_count = 0;
+    int64_t first_equal = -1;
+    for (int64_t index = 0; index < size; index++) {
+        ASSERT_EQ(expected[size + index], lhs[indices[index]]) << index;
+        ASSERT_EQ(expected[2 * size + index], T(lhs[index] * rhs[index] + T(index))) << index;
+        less_count += lhs[index] < rhs[index];
+        if (first_equal < 0 && lhs[index] == rhs[index])
+            first_equal = index;
+    }
+    ASSERT_EQ(expected[3 * size], std::accumulate(lhs.begin(), lhs.end(), T(0)));
+    ASSERT_EQ(expected[3 * size + 1], *std::min_element(lhs.begin(), lhs.end()));
+    ASSERT_EQ(expected[3 * size + 2], *std::max_element(lhs.begin(), lhs.end()));
+    ASSERT_EQ(expected[3 * size + 3], T(less_count));
+    ASSERT_EQ(expected[3 * size + 4], T(first_equal));
+
+    // the values are small integers, so all the units give the same results
+    std::vector<decltype(function.Get())> variants;
+    for (const auto inset : TEST_INSETS) {
+        variants.push_back(function.Get(inset));
+    }
+    for (const auto* profile : CU::INSETS_PROFILES) {
+        variants.push_back(function.Get(*profile));
+    }
+    for (const auto variant : variants) {
+        if (!variant)
+            continue;
+        std::vector<T> results(expected.size(), sentinel);
+        variant(lhs.data(), rhs.data(), indices.data(), size, results.data());
+        for (size_t index = 0; index < results.size(); index++) {
+            ASSERT_EQ(std::memcmp(&results[index], &expected[index], sizeof(T)), 0) <<
+                index << ": " << results[index] << " != " << expected[index];
+        }
+    }
+}
+
+TEST(SimdVectorTest, SameInAllUnits) {
+    std::mt19937 generator{ 42 };
+    std::uniform_int_distribution<int32_t> value_distribution{ -50, 50 };
+    // the inputs of all the types are filled by one loop, the range constructors of std::vector
+    // fail -Wstrict-overflow in optimized builds
+    for (const int64_t size : { 1, 15, 16, 17, 1003 }) {
+        std::uniform_int_distribution<int32_t> index_distribution{ 0, int32_t(size - 1) };
+        std::vector<int32_t> lhs(size), rhs(size), indices(size);
+        std::vector<float> lhs_float(size), rhs_float(size);
+        std::vector<double> lhs_double(size), rhs_double(size);
+        for (int64_t index = 0; index < size; index++) {
+            lhs[index] = value_distribution(generator);
+            rhs[index] = value_distribution(generator);
+            indices[index] = index_distribution(generator);
+            lhs_float[index] = float(lhs[index]);
+            rhs_float[index] = float(rhs[index]);
+            lhs_double[index] = double(lhs[index]);
+            rhs_double[index] = double(rhs[index]);
+        }
+
+        check_simd_vector_units(simd_vector_int32, lhs, rhs, indices);
+        check_simd_vector_units(simd_vector_float, lhs_float, rhs_float, indices);
+        check_simd_vector_units(simd_vector_double, lhs_double, rhs_double, indices);
+    }
+}
+
+TEST(SimdVectorTest, Backends) {
+    // the width of the vectors is chosen by the compile unit
+    ASSERT_STREQ(simd_vector_backend.Get(CU::DEFAULT_INSET)(), "SCALAR");
+#if defined(CU_ARCH_X86_64)
+    const std::pair<CU::InstructionsSet, const char*> backends[] = {
+        { CU::E_INSET_SSE4_2, "SSE4" }, { CU::E_INSET_AVX2, "AVX2" }, { CU::E_INSET_AVX512F, "AVX512" } };
+    for (const auto& [inset, backend] : backends) {
+        if (const auto function = simd_vector_backend.Get(inset)) {
+            ASSERT_STREQ(function(), backend);
+        }
+    }
+    if (const auto function = simd_vector_backend.Get(CU::INSET_PROFILE_X86_64_V4)) {
+        ASSERT_STREQ(function(), "AVX512");
+    }
+#endif // CU_ARCH_X86_64
+}
+
+int main(int argc, char* argv[]) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
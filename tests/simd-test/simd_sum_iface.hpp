@@ -0,0 +1,10 @@
+// Copyright (c) 2025, Yakov Usoltsev
+// Email: yakovmen62@gmail.com
+//
+// License: MIT
+
+// interface of the test SIMD function, included by the generated simd_sum.hpp
+
+#include <stdint.h>
+
+CU_SIMD_FUNCTION(float, simd_sum, const float* values, int64_t size)
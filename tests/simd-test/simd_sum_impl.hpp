@@ -0,0 +1,70 @@
+// Copyright (c) 2025, Yakov Usoltsev
+// Email: yakovmen62@gmail.com
+//
+// License: MIT
+
+#include "simd_sum.hpp"
+
+#include <cstring>
+
+#if defined(CU_COMPILE_UNIT_AVX512_FAMILY)
+#  include <immintrin.h>
+#  define SIMD_SUM_WIDTH 16
+#  define SIMD_SUM_VECTOR __m512
+#  define SIMD_SUM_ZERO _mm512_setzero_ps
+#  define SIMD_SUM_ADD(sum, ptr) _mm512_add_ps(sum, _mm512_loadu_ps(ptr))
+#elif defined(CU_COMPILE_UNIT_AVX2)
+#  include <immintrin.h>
+#  define SIMD_SUM_WIDTH 8
+#  define SIMD_SUM_VECTOR __m256
+#  define SIMD_SUM_ZERO _mm256_setzero_ps
+#  define SIMD_SUM_ADD(sum, ptr) _mm256_add_ps(sum, _mm256_loadu_ps(ptr))
+#elif defined(CU_COMPILE_UNIT_SSE4_2)
+#  include <nmmintrin.h>
+#  define SIMD_SUM_WIDTH 4
+#  define SIMD_SUM_VECTOR __m128
+#  define SIMD_SUM_ZERO _mm_setzero_ps
+#  define SIMD_SUM_ADD(sum, ptr) _mm_add_ps(sum, _mm_loadu_ps(ptr))
+#elif defined(CU_COMPILE_UNIT_NEON)
+#  include <arm_neon.h>
+#  define SIMD_SUM_WIDTH 4
+#  define SIMD_SUM_VECTOR float32x4_t
+#  define SIMD_SUM_ZERO() vdupq_n_f32(0.0f)
+#  define SIMD_SUM_ADD(sum, ptr) vaddq_f32(sum, vld1q_f32(ptr))
+#elif defined(CU_COMPILE_UNIT_SVE_FAMILY)
+#  include <arm_sve.h>
+#endif // CU_COMPILE_UNIT_*
+
+#if defined(CU_COMPILE_UNIT_SVE_FAMILY)
+// the vector length is known at run time only, the tail is handled by the predicate
+float CU_SIMD(simd_sum)(const float* values, int64_t size) {
+    svfloat32_t sum = svdup_n_f32(0.0f);
+    for (int64_t index = 0; index < size; index += int64_t(svcntw())) {
+        const svbool_t mask = svwhilelt_b32(index, size);
+        sum = svadd_f32_m(mask, sum, svld1_f32(mask, values + index));
+    }
+    return svaddv_f32(svptrue_b32(), sum);
+}
+#else
+float CU_SIMD(simd_sum)(const float* values, int64_t size) {
+    float result = 0.0f;
+    int64_t index = 0;
+#if defined(SIMD_SUM_WIDTH)
+    SIMD_SUM_VECTOR sum = SIMD_SUM_ZERO();
+    const int64_t vectors_size = size - size % SIMD_SUM_WIDTH;
+    for (; index < vectors_size; index += SIMD_SUM_WIDTH) {
+        sum = SIMD_SUM_ADD(sum, values + index);
+    }
+
+    float lanes[SIMD_SUM_WIDTH];
+    std::memcpy(lanes, &sum, sizeof(lanes));
+    for (const auto lane : lanes) {
+        result += lane;
+    }
+#endif // SIMD_SUM_WIDTH
+    for (; index < size; index++) {
+        result += values[index];
+    }
+    return result;
+}
+#endif // CU_COMPILE_UNIT_SVE_FAMILY
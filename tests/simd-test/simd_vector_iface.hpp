@@ -0,0 +1,17 @@
+// Copyright (c) 2025, Yakov Usoltsev
+// Email: yakovmen62@gmail.com
+//
+// License: MIT
+
+// interface of the test kernels written with CU::Simd::Vector, included by the generated simd_vector.hpp
+// the results layout is described in simd_vector_impl.hpp
+
+#include <stdint.h>
+
+CU_SIMD_FUNCTION(const char*, simd_vector_backend)
+CU_SIMD_FUNCTION(void, simd_vector_float,
+    const float* lhs, const float* rhs, const int32_t* indices, int64_t size, float* results)
+CU_SIMD_FUNCTION(void, simd_vector_double,
+    const double* lhs, const double* rhs, const int32_t* indices, int64_t size, double* results)
+CU_SIMD_FUNCTION(void, simd_vector_int32,
+    const int32_t* lhs, const int32_t* rhs, const int32_t* indices, int64_t size, int32_t* results)
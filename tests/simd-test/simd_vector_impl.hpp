@@ -0,0 +1,80 @@
+// Copyright (c) 2025, Yakov Usoltsev
+// Email: yakovmen62@gmail.com
+//
+// License: MIT
+
+#include "simd_vector.hpp"
+
+#include <cu/simd-vector-utils.hpp>
+
+#include <type_traits>
+
+// The same kernel is compiled into every unit, the results of all the units must be equal.
+// results[0, size)            - elementwise arithmetic, comparisons and select
+// results[size, 2 * size)     - gather of lhs by indices
+// results[2 * size, 3 * size) - mul_add of lhs, rhs and the index
+// results[3 * size, ...)      - sum, min, max of lhs, count of lhs < rhs and the first index where lhs == rhs
+template<typename T>
+static void simd_vector_kernel(const T* lhs, const T* rhs, const int32_t* indices, int64_t size, T* results) {
+    using Vector = CU::Simd::Vector<T>;
+    constexpr auto LANES = Vector::LANES;
+
+    auto sum = Vector::Zero();
+    auto minimum = Vector::Broadcast(lhs[0]);
+    auto maximum = Vector::Broadcast(lhs[0]);
+    int64_t less_count = 0;
+    int64_t first_equal = -1;
+    for (int64_t index = 0; index < size; index += LANES) {
+        const auto count = size - index;
+        // the zero lanes of the tail are replaced by the first value
+        const auto is_tail = Vector::Iota(T(0)) < Vector::Broadcast(T(count));
+        const auto x = CU::Simd::select(is_tail, Vector::LoadPartial(lhs + index, count), Vector::Broadcast(lhs[0]));
+        const auto y = CU::Simd::select(is_tail, Vector::LoadPartial(rhs + index, count), Vector::Broadcast(lhs[0]));
+
+        auto elementwise = CU::Simd::select(x < y,
+            x * y + CU::Simd::abs(x),
+            CU::Simd::max(x, y) - CU::Simd::min(x, y));
+        if constexpr (std::is_floating_point_v<T>) {
+            elementwise += CU::Simd::select(y != Vector::Zero(), x / y, CU::Simd::sqrt(CU::Simd::abs(x)));
+        }
+        elementwise.StorePartial(results + index, count);
+
+        alignas(64) int32_t tail_indices[LANES] = {};
+        for (int64_t lane = 0; lane < LANES && lane < count; lane++) {
+            tail_indices[lane] = indices[index + lane];
+        }
+        Vector::Gather(lhs, tail_indices).StorePartial(results + size + index, count);
+
+        CU::Simd::mul_add(x, y, Vector::Iota(T(index))).StorePartial(results + 2 * size + index, count);
+
+        sum += CU::Simd::select(is_tail, x, Vector::Zero());
+        minimum = CU::Simd::min(minimum, x);
+        maximum = CU::Simd::max(maximum, x);
+        less_count += CU::Simd::count_true(is_tail & (x < y));
+        const auto is_equal = is_tail & !(x != y);
+        if (first_equal < 0 && CU::Simd::any(is_equal))
+            first_equal = index + CU::Simd::find_first(is_equal);
+    }
+
+    results[3 * size] = CU::Simd::reduce_add(sum);
+    results[3 * size + 1] = CU::Simd::reduce_min(minimum);
+    results[3 * size + 2] = CU::Simd::reduce_max(maximum);
+    results[3 * size + 3] = T(less_count);
+    results[3 * size + 4] = T(first_equal);
+}
+
+const char* CU_SIMD(simd_vector_backend)() {
+    return CU::Simd::VECTOR_BACKEND;
+}
+
+void CU_SIMD(simd_vector_float)(const float* lhs, const float* rhs, const int32_t* indices, int64_t size, float* results) {
+    simd_vector_kernel(lhs, rhs, indices, size, results);
+}
+
+void CU_SIMD(simd_vector_double)(const double* lhs, const double* rhs, const int32_t* indices, int64_t size, double* results) {
+    simd_vector_kernel(lhs, rhs, indices, size, results);
+}
+
+void CU_SIMD(simd_vector_int32)(const int32_t* lhs, const int32_t* rhs, const int32_t* indices, int64_t size, int32_t* results) {
+    simd_vector_kernel(lhs, rhs, indices, size, results);
+}